@@ -28,6 +28,7 @@
 #include "exceptions.hpp"
 #include "fifo.hpp"
 #include "filesystem.hpp"
+#include "function.hpp"
 #include "hash.hpp"
 #include "ipc.hpp"
 #include "log.hpp"
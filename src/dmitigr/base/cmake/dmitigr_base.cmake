@@ -35,8 +35,10 @@ set(dmitigr_base_headers
   exceptions.hpp
   fifo.hpp
   filesystem.hpp
+  function.hpp
   hash.hpp
   ipc.hpp
+  lock.hpp
   log.hpp
   memory.hpp
   noncopymove.hpp
@@ -65,5 +67,5 @@ endif()
 
 if(DMITIGR_LIBS_TESTS)
   set(dmitigr_base_tests assoc_vector buffer chrono filesystem
-    fifo_array fifo_string hash log math rnd stack str thread utility)
+    fifo_array fifo_string function hash log math rnd stack str thread utility)
 endif()
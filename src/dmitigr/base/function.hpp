@@ -0,0 +1,190 @@
+// -*- C++ -*-
+//
+// Copyright 2026 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DMITIGR_BASE_FUNCTION_HPP
+#define DMITIGR_BASE_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dmitigr {
+
+/// @see The specialization below.
+template<typename, std::size_t Size = 64> class Inplace_function;
+
+/**
+ * @brief An alternative of std::function with guaranteed in-place storage.
+ *
+ * @details Unlike std::function, the target is always stored within the
+ * instance: a target which doesn't fit into `Size` bytes is rejected at
+ * compile time rather than placed on the heap. Thus, neither construction
+ * nor assignment ever allocates, and an invocation loads the target from
+ * a stable location.
+ */
+template<typename R, typename... Args, std::size_t Size>
+class Inplace_function<R(Args...), Size> final {
+public:
+  /// The destructor.
+  ~Inplace_function()
+  {
+    reset();
+  }
+
+  /// Constructs the empty instance.
+  Inplace_function() noexcept
+  {}
+
+  /// @overload
+  Inplace_function(std::nullptr_t) noexcept
+  {}
+
+  /**
+   * @brief Constructs the instance with the target `callable`.
+   *
+   * @par Requires
+   * `sizeof(callable) <= Size` (checked at compile time).
+   */
+  template<typename F>
+  requires (!std::is_same_v<std::remove_cvref_t<F>, Inplace_function> &&
+    std::is_invocable_r_v<R, std::remove_cvref_t<F>&, Args...>)
+  Inplace_function(F&& callable)
+  {
+    using Fn = std::remove_cvref_t<F>;
+    static_assert(sizeof(Fn) <= Size,
+      "the target of Inplace_function exceeds the in-place storage");
+    static_assert(alignof(Fn) <= alignof(std::max_align_t));
+    ::new (static_cast<void*>(storage_)) Fn{std::forward<F>(callable)};
+    ops_ = &ops<Fn>;
+  }
+
+  /// The copy constructor.
+  Inplace_function(const Inplace_function& rhs)
+  {
+    if (rhs.ops_) {
+      rhs.ops_->copy(rhs.storage_, storage_);
+      ops_ = rhs.ops_;
+    }
+  }
+
+  /// The copy assignment operator.
+  Inplace_function& operator=(const Inplace_function& rhs)
+  {
+    if (this != &rhs) {
+      Inplace_function tmp{rhs};
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+
+  /// The move constructor.
+  Inplace_function(Inplace_function&& rhs) noexcept
+  {
+    if (rhs.ops_) {
+      rhs.ops_->move(rhs.storage_, storage_);
+      ops_ = rhs.ops_;
+      rhs.reset();
+    }
+  }
+
+  /// The move assignment operator.
+  Inplace_function& operator=(Inplace_function&& rhs) noexcept
+  {
+    if (this != &rhs) {
+      reset();
+      if (rhs.ops_) {
+        rhs.ops_->move(rhs.storage_, storage_);
+        ops_ = rhs.ops_;
+        rhs.reset();
+      }
+    }
+    return *this;
+  }
+
+  /// The swap operation.
+  void swap(Inplace_function& rhs) noexcept
+  {
+    auto tmp = std::move(rhs);
+    rhs = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+  /// Makes the instance empty.
+  void reset() noexcept
+  {
+    if (ops_) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  /// @returns `true` if the instance has a target.
+  explicit operator bool() const noexcept
+  {
+    return static_cast<bool>(ops_);
+  }
+
+  /**
+   * @brief Invokes the target.
+   *
+   * @throws std::bad_function_call if `!*this`.
+   */
+  R operator()(Args... args) const
+  {
+    if (!ops_)
+      throw std::bad_function_call{};
+    return ops_->invoke(storage_, std::forward<Args>(args)...);
+  }
+
+private:
+  struct Ops final {
+    R(*invoke)(const unsigned char*, Args&&...);
+    void(*copy)(const unsigned char*, unsigned char*);
+    void(*move)(unsigned char*, unsigned char*);
+    void(*destroy)(unsigned char*);
+  };
+
+  template<typename Fn>
+  static constexpr Ops ops{
+    [](const unsigned char* const target, Args&&... args) -> R
+    {
+      // Mimics std::function: const-callable, non-const target.
+      return (*reinterpret_cast<Fn*>(const_cast<unsigned char*>(target)))(
+        std::forward<Args>(args)...);
+    },
+    [](const unsigned char* const src, unsigned char* const dst)
+    {
+      ::new (static_cast<void*>(dst)) Fn{*reinterpret_cast<const Fn*>(src)};
+    },
+    [](unsigned char* const src, unsigned char* const dst)
+    {
+      ::new (static_cast<void*>(dst)) Fn{std::move(*reinterpret_cast<Fn*>(src))};
+    },
+    [](unsigned char* const target)
+    {
+      reinterpret_cast<Fn*>(target)->~Fn();
+    }
+  };
+
+  const Ops* ops_{};
+  alignas(std::max_align_t) unsigned char storage_[Size];
+};
+
+} // namespace dmitigr
+
+#endif  // DMITIGR_BASE_FUNCTION_HPP
@@ -45,11 +45,24 @@ public:
 class Request : public Message {};
 
 /// A response message.
-class Response : public Message {};
+class Response : public Message {
+public:
+  /// @returns `true` if this instance is an Error.
+  virtual bool is_error() const noexcept
+  {
+    return false;
+  }
+};
 
 /// An error response message.
 class Error : public Response {
 public:
+  /// @returns `true`.
+  bool is_error() const noexcept override
+  {
+    return true;
+  }
+
   /// Throws exception by using this instance.
   [[noreturn]] virtual void throw_from_this() const = 0;
 };
@@ -57,15 +57,21 @@
 #include "basics.hpp"
 #include "chrono.hpp"
 
+#include <array>
 #include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
+#include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
+#include <utility>
 
 #ifdef DMITIGR_LOG_WITH_DEFAULT_PREFIX
 #ifndef DMITIGR_LOG_PREFIX_WRITER
@@ -220,6 +226,163 @@ namespace detail {
 
 inline std::ofstream stderr_file_stream;
 
+/// The mutex which serializes the writes to the log streams.
+inline std::mutex stream_mutex;
+
+/// `true` if the entries are written by the background writer.
+inline std::atomic<bool> is_async{};
+
+/// A complete log entry, ready to be written to `*os`.
+struct Record final {
+  std::ostream* os{};
+  Level level{};
+#ifdef DMITIGR_LOG_NOW
+  decltype(DMITIGR_LOG_NOW()) time{};
+#endif
+  std::string text;
+};
+
+/// Writes the `record` to `*record.os` under stream_mutex.
+inline void write_record(const Record& record)
+{
+  const std::lock_guard lg{stream_mutex};
+#ifdef DMITIGR_LOG_WITH_LEVEL
+  char lvl[3];
+  lvl[0] = '<';
+  lvl[1] = 48 + static_cast<int>(record.level);
+  lvl[2] = '>';
+  record.os->write(lvl, sizeof(lvl));
+#endif
+#ifdef DMITIGR_LOG_PREFIX_WRITER
+  DMITIGR_LOG_PREFIX_WRITER(*record.os, record.time);
+#endif
+  record.os->write(record.text.data(), record.text.size());
+  record.os->put('\n');
+}
+
+/**
+ * @brief The background log writer.
+ *
+ * @details The records are published into a fixed-size multi-producer ring
+ * (a bounded queue of the Vyukov kind): on the caller's side a log entry
+ * costs a string move plus two atomic updates - no lock and no stream I/O.
+ * The single background thread consumes the ring and performs the writes.
+ * When the ring is full the caller falls back to the synchronous write
+ * rather than dropping the record.
+ */
+class Async_writer final {
+public:
+  /// Writes the records left in the ring out and joins the thread.
+  ~Async_writer()
+  {
+    is_started_.store(false, std::memory_order_release);
+    {
+      const std::lock_guard lg{mutex_};
+    }
+    changed_.notify_all();
+    thread_.join();
+    Record record;
+    while (dequeue(record))
+      write_record(record);
+  }
+
+  /// Starts the background thread.
+  Async_writer()
+  {
+    for (std::size_t i{}; i < ring_size; ++i)
+      ring_[i].seq.store(i, std::memory_order_relaxed);
+    is_started_.store(true, std::memory_order_release);
+    thread_ = std::thread{&Async_writer::run, this};
+  }
+
+  /// @returns `true` if the `record` is queued for writing.
+  bool enqueue(Record&& record)
+  {
+    auto pos = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      auto& slot = ring_[pos % ring_size];
+      const auto seq = slot.seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) -
+        static_cast<std::ptrdiff_t>(pos);
+      if (diff < 0)
+        return false; // the ring is full
+      else if (diff > 0)
+        pos = tail_.load(std::memory_order_relaxed);
+      else if (tail_.compare_exchange_weak(pos, pos + 1,
+          std::memory_order_relaxed)) {
+        slot.record = std::move(record);
+        slot.seq.store(pos + 1, std::memory_order_release);
+        break;
+      }
+    }
+    pending_.fetch_add(1, std::memory_order_release);
+    {
+      const std::lock_guard lg{mutex_};
+    }
+    changed_.notify_one();
+    return true;
+  }
+
+private:
+  constexpr static std::size_t ring_size{1024};
+
+  struct alignas(64) Slot final {
+    std::atomic<std::size_t> seq{};
+    Record record;
+  };
+
+  std::array<Slot, ring_size> ring_;
+  std::atomic<std::size_t> tail_{};
+  std::size_t head_{}; // the consumer-side index
+  std::atomic<std::ptrdiff_t> pending_{};
+  std::atomic<bool> is_started_{};
+  mutable std::mutex mutex_; // guards the sleeping on `changed_` only
+  std::condition_variable changed_;
+  std::thread thread_;
+
+  /// @returns `true` if a record is moved into `record`. (Consumer only.)
+  bool dequeue(Record& record)
+  {
+    auto& slot = ring_[head_ % ring_size];
+    if (slot.seq.load(std::memory_order_acquire) != head_ + 1)
+      return false;
+    record = std::move(slot.record);
+    slot.record.text.clear();
+    slot.seq.store(head_ + ring_size, std::memory_order_release);
+    ++head_;
+    pending_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void run() noexcept
+  {
+    while (true) {
+      try {
+        Record record;
+        if (dequeue(record)) {
+          write_record(record);
+          continue;
+        }
+        std::unique_lock lk{mutex_};
+        changed_.wait(lk, [this]() noexcept
+        {
+          return pending_.load(std::memory_order_acquire) > 0 ||
+            !is_started_.load(std::memory_order_acquire);
+        });
+        if (!is_started_.load(std::memory_order_acquire))
+          break;
+      } catch (...) {}
+    }
+  }
+};
+
+/// @returns The background log writer, started upon the first call.
+inline Async_writer& async_writer()
+{
+  static Async_writer result;
+  return result;
+}
+
 /**
  * @brief Writes the entry to the `os` according to the format string `fmt`.
  *
@@ -230,35 +393,39 @@ inline void write(std::ostream& os, const Level level,
   const std::string_view fmt, std::format_args&& args)
 {
   if (level <= log::level) {
+    Record record{&os, level};
 #ifdef DMITIGR_LOG_NOW
-    const auto now = DMITIGR_LOG_NOW();
+    record.time = DMITIGR_LOG_NOW();
 #endif
-#ifdef DMITIGR_LOG_WITH_LEVEL
-    char lvl[3];
-    lvl[0] = '<';
-    lvl[1] = 48 + static_cast<int>(level);
-    lvl[2] = '>';
-#else
-    (void)level;
-#endif
-
-    const auto output = std::vformat(fmt, args);
-
-    static std::mutex mutex;
-    const std::lock_guard lg{mutex};
-#ifdef DMITIGR_LOG_WITH_LEVEL
-    os.write(lvl, sizeof(lvl));
-#endif
-#ifdef DMITIGR_LOG_PREFIX_WRITER
-    DMITIGR_LOG_PREFIX_WRITER(os, now);
-#endif
-    os.write(output.data(), output.size());
-    os.put('\n');
+    record.text = std::vformat(fmt, args);
+    if (is_async.load(std::memory_order_acquire) &&
+      async_writer().enqueue(std::move(record)))
+      return;
+    write_record(record);
   }
 }
 
 } // namespace detail
 
+/**
+ * @brief Enables or disables the background log writer.
+ *
+ * @details When enabled, a log entry costs the caller only the formatting
+ * and the publishing into the writer's ring: the stream I/O (and the wait
+ * on the stream mutex) happens on the dedicated background thread. When
+ * the ring is full the caller writes synchronously, so no entry is ever
+ * dropped.
+ *
+ * @remarks The records left in the ring are written out on normal program
+ * exit.
+ */
+inline void set_async(const bool value)
+{
+  if (value)
+    detail::async_writer(); // start the writer before publishing the flag
+  detail::is_async.store(value, std::memory_order_release);
+}
+
 /**
  * @brief Redirects the both stantard error streams (`std::cerr` and
  * `std::clog`) to the file at `path`.
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cctype>
 #include <cstring>
@@ -412,6 +413,40 @@ inline bool has_space(const std::string_view str) noexcept
   return std::any_of(cbegin(str), cend(str), is_space);
 }
 
+/**
+ * @returns `true` if `str` has at least one ASCII whitespace character.
+ *
+ * @remarks Unlike has_space(), tests against the fixed set of whitespace
+ * characters regardless of the locale currently in effect, and scans 8-byte
+ * chunks branch-free (SWAR).
+ */
+inline bool has_ascii_space(const std::string_view str) noexcept
+{
+  // @returns The word with 0x80 set in every byte of `x` which equals `ch`.
+  constexpr auto eq = [](const std::uint64_t x, const char ch) noexcept
+  {
+    constexpr std::uint64_t ones{0x0101010101010101ull};
+    const auto v = x ^ (static_cast<std::uint64_t>(
+      static_cast<unsigned char>(ch)) * ones);
+    return (v - ones) & ~v & 0x8080808080808080ull;
+  };
+  const char* ptr{str.data()};
+  auto size = str.size();
+  for (; size >= 8; ptr += 8, size -= 8) {
+    std::uint64_t x;
+    std::memcpy(&x, ptr, 8);
+    if (eq(x, ' ') | eq(x, '\t') | eq(x, '\n') |
+      eq(x, '\v') | eq(x, '\f') | eq(x, '\r'))
+      return true;
+  }
+  for (; size; ++ptr, --size) {
+    const char ch{*ptr};
+    if (ch == ' ' || (ch >= '\t' && ch <= '\r'))
+      return true;
+  }
+  return false;
+}
+
 /// @returns `true` if `input` is starting with `pattern`.
 inline bool is_begins_with(const std::string_view input,
   const std::string_view pattern) noexcept
@@ -678,34 +713,28 @@ inline std::string sparsed_string(const std::string_view input,
     return result;
   }
 
-  // Go generic path.
-  const auto [elem_sz, fmt_str] = [result_format]
-  {
-    switch (result_format) {
-    case Byte_format::raw: return std::make_pair(1u, "%c");
-    case Byte_format::hex: return std::make_pair(2u, "%02x");
+  // Go fast path if `hex`: two table lookups per byte instead of the cost
+  // of a std::snprintf() call each.
+  if (result_format == Byte_format::hex) {
+    static constexpr char digits[]{"0123456789abcdef"};
+    result.resize(input.size()*2 + (input.size() - 1)*delimiter.size());
+    char* out{result.data()};
+    using Size = std::string_view::size_type;
+    for (Size i{}; i < input.size(); ++i) {
+      if (i) {
+        std::memcpy(out, delimiter.data(), delimiter.size());
+        out += delimiter.size();
+      }
+      const auto byte = static_cast<unsigned char>(input[i]);
+      *out++ = digits[byte >> 4];
+      *out++ = digits[byte & 0xf];
     }
-    throw std::invalid_argument{"unsupported result format for"
-      " dmitigr::str::to_string(string_view, Byte_format, string_view)"};
-  }();
-
-  result.resize(
-    input.size()*elem_sz + // for bytes in result_format
-    1 + // for `\0` written by std::snprintf()
-    input.size()*delimiter.size() // for delimiters
-                );
-  using Size = std::string_view::size_type;
-  for (Size i{}; i < input.size(); ++i) {
-    auto* const res = result.data() + elem_sz*i + delimiter.size()*i;
-    DMITIGR_ASSERT(res >= result.data() &&
-      static_cast<Size>(res - result.data()) <= result.size());
-    const auto count = std::snprintf(res, elem_sz + 1, fmt_str,
-      static_cast<unsigned char>(input[i]));
-    DMITIGR_ASSERT(static_cast<Size>(count) == elem_sz);
-    std::strncpy(res + count, delimiter.data(), delimiter.size());
+    DMITIGR_ASSERT(out == result.data() + result.size());
+    return result;
   }
-  result.resize(result.size() - 1 - delimiter.size());
-  return result;
+
+  throw std::invalid_argument{"unsupported result format for"
+    " dmitigr::str::to_string(string_view, Byte_format, string_view)"};
 }
 
 /// Eliminates duplicate characters from string `str`.
@@ -860,6 +889,36 @@ inline void lowercase(std::string& str)
   transform(b, e, b, [](const auto c){return tolower(c);});
 }
 
+/**
+ * @brief Replaces all of uppercase ASCII characters in `str` by the
+ * corresponding lowercase characters.
+ *
+ * @remarks Unlike lowercase(), ignores the locale (bytes above 127 are left
+ * intact) and processes 8-byte chunks branch-free (SWAR).
+ */
+inline void lowercase_ascii(std::string& str) noexcept
+{
+  constexpr std::uint64_t ones{0x0101010101010101ull};
+  constexpr std::uint64_t highs{0x8080808080808080ull};
+  auto* ptr = str.data();
+  auto size = str.size();
+  for (; size >= 8; ptr += 8, size -= 8) {
+    std::uint64_t x;
+    std::memcpy(&x, ptr, 8);
+    const auto ascii = x & ~highs;
+    // 0x80 in every lane of ['A', 'Z'] with the high bit originally unset.
+    const auto upper = (ascii + (0x80 - 'A') * ones) &
+      ~(ascii + (0x80 - 'Z' - 1) * ones) & ~x & highs;
+    x |= upper >> 2;
+    std::memcpy(ptr, &x, 8);
+  }
+  for (; size; ++ptr, --size) {
+    const auto ch = *ptr;
+    if ('A' <= ch && ch <= 'Z')
+      *ptr = static_cast<char>(ch | 0x20);
+  }
+}
+
 /**
  * @returns The modified copy of the `str` with all of uppercase characters
  * replaced by the corresponding lowercase characters.
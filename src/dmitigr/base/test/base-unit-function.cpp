@@ -0,0 +1,89 @@
+// -*- C++ -*-
+//
+// Copyright 2026 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "../../base/assert.hpp"
+#include "../../base/function.hpp"
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+
+int main()
+{
+  try {
+    using dmitigr::Inplace_function;
+
+    // Empty.
+    {
+      Inplace_function<int()> fn;
+      DMITIGR_ASSERT(!fn);
+      bool thrown{};
+      try {
+        fn();
+      } catch (const std::bad_function_call&) {
+        thrown = true;
+      }
+      DMITIGR_ASSERT(thrown);
+    }
+
+    // Invocation, capture, state.
+    {
+      int count{};
+      Inplace_function<int(int)> fn{[&count](const int x)
+      {
+        return ++count, x * 2;
+      }};
+      DMITIGR_ASSERT(fn);
+      DMITIGR_ASSERT(fn(21) == 42);
+      DMITIGR_ASSERT(count == 1);
+    }
+
+    // Copy and move.
+    {
+      const std::string word{"hello"};
+      Inplace_function<std::string()> fn{[word]{return word;}};
+      auto copy = fn;
+      DMITIGR_ASSERT(fn && copy);
+      DMITIGR_ASSERT(copy() == "hello");
+      auto moved = std::move(copy);
+      DMITIGR_ASSERT(moved && !copy);
+      DMITIGR_ASSERT(moved() == "hello");
+      moved.reset();
+      DMITIGR_ASSERT(!moved);
+    }
+
+    // Assignment and swap.
+    {
+      Inplace_function<int()> fn1{[]{return 1;}};
+      Inplace_function<int()> fn2{[]{return 2;}};
+      fn1.swap(fn2);
+      DMITIGR_ASSERT(fn1() == 2);
+      DMITIGR_ASSERT(fn2() == 1);
+      fn1 = nullptr;
+      DMITIGR_ASSERT(!fn1);
+      fn1 = std::move(fn2);
+      DMITIGR_ASSERT(fn1() == 1);
+      DMITIGR_ASSERT(!fn2);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "unknown error" << std::endl;
+    return 2;
+  }
+}
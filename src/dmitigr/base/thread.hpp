@@ -19,7 +19,9 @@
 
 #include "assert.hpp"
 #include "exceptions.hpp"
+#include "function.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -100,8 +102,14 @@ void sleep_for_remaining(const std::chrono::time_point<Clock> started,
 /// Simple thread pool.
 class Pool final {
 public:
-  /// A task.
-  using Task = std::function<void()>;
+  /**
+   * @brief A task.
+   *
+   * @remarks The captures are stored in place: submitting a task allocates
+   * no memory. A task with captures over 128 bytes is rejected at compile
+   * time - such state belongs behind a pointer anyway.
+   */
+  using Task = Inplace_function<void(), 128>;
 
   /// A logger.
   using Logger = std::function<void(std::string_view)>;
@@ -110,9 +118,9 @@ public:
   ~Pool()
   {
     // Stop queue.
+    queue_.is_started.store(false, std::memory_order_release);
     {
       const std::lock_guard lg{queue_.mutex};
-      queue_.is_started = false;
     }
     queue_.changed.notify_all();
 
@@ -164,10 +172,14 @@ public:
     if (!size)
       return;
 
-    queue_.is_started = true;
+    queue_.is_started.store(true, std::memory_order_release);
+    const auto shard_count = static_cast<std::size_t>(std::min<std::ptrdiff_t>(
+      size, max_shard_count));
+    queue_.shards = std::vector<Shard>(shard_count);
     pool_.threads.reserve(size);
     for (std::ptrdiff_t i{}; i < size; ++i)
-      pool_.threads.emplace_back(&Pool::wait_and_run, this);
+      pool_.threads.emplace_back(&Pool::wait_and_run, this,
+        static_cast<std::size_t>(i) % shard_count);
   }
 
 #ifdef __linux__
@@ -208,6 +220,11 @@ public:
   /**
    * @brief Submit the task to run on the thread pool.
    *
+   * @details The queue is sharded: the task goes to one of the shards in a
+   * round-robin manner, so the concurrent submitters contend on different
+   * mutexes rather than on a single global one. (The global mutex is only
+   * touched to wake an idle worker.)
+   *
    * @par Requires
    * `task`.
    */
@@ -215,26 +232,37 @@ public:
   {
     if (!task)
       throw Exception{"cannot submit invalid task to thread pool"};
-
-    const std::lock_guard lg{queue_.mutex};
-    if (!queue_.is_started)
+    else if (!queue_.is_started.load(std::memory_order_acquire))
       throw Exception{"cannot submit task to invalid thread pool"};
-    queue_.tasks.push(std::move(task));
+
+    auto& shard = queue_.shards[queue_.next.fetch_add(1,
+      std::memory_order_relaxed) % queue_.shards.size()];
+    {
+      const std::lock_guard lg{shard.mutex};
+      shard.tasks.push(std::move(task));
+    }
+    queue_.pending.fetch_add(1, std::memory_order_release);
+    {
+      const std::lock_guard lg{queue_.mutex};
+    }
     queue_.changed.notify_one();
   }
 
   /// Clears the queue of unstarted tasks.
   void clear() noexcept
   {
-    const std::lock_guard lg{queue_.mutex};
-    queue_.tasks = {};
+    for (auto& shard : queue_.shards) {
+      const std::lock_guard lg{shard.mutex};
+      queue_.pending.fetch_sub(ssize(shard.tasks),
+        std::memory_order_relaxed);
+      shard.tasks = {};
+    }
   }
 
   /// @returns The size of task queue.
   auto queue_size() const noexcept
   {
-    const std::lock_guard lg{queue_.mutex};
-    return ssize(queue_.tasks);
+    return queue_.pending.load(std::memory_order_relaxed);
   }
 
   /// @returns The thread pool size.
@@ -251,11 +279,21 @@ public:
   }
 
 private:
+  /// A partition of the task queue, padded to its own cache lines.
+  struct alignas(64) Shard final {
+    std::mutex mutex;
+    std::queue<Task> tasks;
+  };
+
+  constexpr static std::ptrdiff_t max_shard_count{8};
+
   struct {
-    mutable std::mutex mutex;
+    mutable std::mutex mutex; // guards the sleeping on `changed` only
     std::condition_variable changed;
-    std::queue<Task> tasks;
-    bool is_started{};
+    std::vector<Shard> shards;
+    std::atomic<std::size_t> next{};
+    std::atomic<std::ptrdiff_t> pending{};
+    std::atomic<bool> is_started{};
   } queue_;
 
   struct {
@@ -266,28 +304,40 @@ private:
 
   Logger logger_;
 
-  void wait_and_run() noexcept
+  void wait_and_run(const std::size_t home) noexcept
   {
+    const auto shard_count = queue_.shards.size();
     while (true) {
       bool is_pool_usage_incremented{};
       try {
+        // Take a task from the home shard, or steal one from a neighbour.
         Task task;
-        {
+        for (std::size_t i{}; i < shard_count && !task; ++i) {
+          auto& shard = queue_.shards[(home + i) % shard_count];
+          const std::lock_guard lg{shard.mutex};
+          if (!shard.tasks.empty()) {
+            task = std::move(shard.tasks.front());
+            DMITIGR_ASSERT(task);
+            shard.tasks.pop();
+            queue_.pending.fetch_sub(1, std::memory_order_relaxed);
+          }
+        }
+
+        if (!task) {
           std::unique_lock lk{queue_.mutex};
           queue_.changed.wait(lk, [this]() noexcept
           {
-            return !queue_.tasks.empty() || !queue_.is_started;
+            return queue_.pending.load(std::memory_order_acquire) > 0 ||
+              !queue_.is_started.load(std::memory_order_acquire);
           });
-          pool_.usage++;
-          is_pool_usage_incremented = true;
-          if (queue_.is_started) {
-            DMITIGR_ASSERT(!queue_.tasks.empty());
-            task = std::move(queue_.tasks.front());
-            DMITIGR_ASSERT(task);
-            queue_.tasks.pop();
-          } else
+          if (queue_.is_started.load(std::memory_order_acquire))
+            continue; // rescan the shards
+          else
             break;
         }
+
+        pool_.usage++;
+        is_pool_usage_incremented = true;
         task();
       } catch (const std::exception& e) {
         log_error(e.what());
@@ -297,7 +347,6 @@ private:
       if (is_pool_usage_incremented)
         pool_.usage--;
     }
-    pool_.usage--;
   }
 
   void log_error(const std::string_view what) const noexcept
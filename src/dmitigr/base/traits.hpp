@@ -52,6 +52,20 @@ struct Is_optional<std::optional<T>> final : std::true_type {};
 template<typename T>
 constexpr bool Is_optional_v = Is_optional<T>::value;
 
+template<typename T>
+struct Optional_value final {
+  using Type = T;
+};
+
+template<typename T>
+struct Optional_value<std::optional<T>> final {
+  using Type = T;
+};
+
+/// An alias of `T` itself, or of `T::value_type` if `T` is `std::optional`.
+template<typename T>
+using Optional_value_t = typename Optional_value<T>::Type;
+
 // -----------------------------------------------------------------------------
 
 template<typename>
@@ -24,6 +24,7 @@
 #include "types_fwd.hpp"
 
 #include <algorithm>
+#include <cstring>
 #include <optional>
 #include <string_view>
 #include <utility>
@@ -180,6 +181,36 @@ public:
       throw Exception{"invalid HTTP cookie string"};
   }
 
+  /**
+   * @returns The value of the cookie `name` extracted directly from `input`,
+   * or `std::nullopt` if there is no such a cookie.
+   *
+   * @remarks Unlike the parsing constructor, involves no allocation, which
+   * makes it suitable for picking a single cookie on a hot path. Malformed
+   * entries are skipped rather than reported.
+   */
+  static std::optional<std::string_view> find(const std::string_view input,
+    const std::string_view name) noexcept
+  {
+    const char* ptr{input.data()};
+    const char* const end{ptr + input.size()};
+    while (ptr < end) {
+      const auto* const sep = static_cast<const char*>(
+        std::memchr(ptr, ';', end - ptr));
+      const char* const entry_end{sep ? sep : end};
+      const auto* const eq = static_cast<const char*>(
+        std::memchr(ptr, '=', entry_end - ptr));
+      if (eq && std::string_view(ptr, eq - ptr) == name)
+        return std::string_view(eq + 1, entry_end - (eq + 1));
+      if (!sep)
+        break;
+      ptr = sep + 1;
+      if (ptr < end && *ptr == ' ')
+        ++ptr;
+    }
+    return std::nullopt;
+  }
+
   /// @see Header::to_header().
   std::unique_ptr<Header> to_header() const override
   {
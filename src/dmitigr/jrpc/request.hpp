@@ -30,6 +30,7 @@
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace dmitigr::jrpc {
 
@@ -243,6 +244,21 @@ public:
     return Request{input, int{}};
   }
 
+  /**
+   * @overload
+   *
+   * @details Unlike the overload taking std::string_view, decodes JSON
+   * strings directly into the `input` buffer (which is retained by the
+   * returned instance) rather than copying every string value into the
+   * DOM-owned storage.
+   *
+   * @param input Stringified JSON that represents a JSON-RPC request.
+   */
+  static Request from_json_insitu(std::vector<char> input)
+  {
+    return Request{std::move(input), int{}};
+  }
+
   /// Constructs an instance that represents a normal request.
   Request(const Null /*id*/, const std::string_view method)
   {
@@ -300,6 +316,7 @@ public:
   /// Swaps this instance with `rhs`.
   void swap(Request& rhs) noexcept
   {
+    buf_.swap(rhs.buf_);
     rep_.Swap(rhs.rep_);
   }
 
@@ -677,6 +694,11 @@ public:
   }
 
 private:
+  /*
+   * The in-situ parse buffer. Must be declared before `rep_`: the string
+   * values of an in-situ parsed `rep_` refer right into it.
+   */
+  std::vector<char> buf_;
   mutable rapidjson::Document rep_{rapidjson::Type::kObjectType};
 
   bool is_invariant_ok() const
@@ -702,6 +724,27 @@ private:
   // Used by from_json().
   Request(const std::string_view input, int) try
     : rep_{rajson::document_from_text(input)}
+  {
+    check_parsed_request();
+    DMITIGR_ASSERT(is_invariant_ok());
+  } catch (const rajson::Parse_exception&) {
+    throw Error{Server_errc::parse_error, null};
+  }
+
+  // Used by from_json_insitu().
+  Request(std::vector<char>&& input, int) try
+    : buf_{std::move(input)}
+  {
+    buf_.push_back('\0');
+    rep_ = rajson::document_from_text_insitu(buf_.data());
+    check_parsed_request();
+    DMITIGR_ASSERT(is_invariant_ok());
+  } catch (const rajson::Parse_exception&) {
+    throw Error{Server_errc::parse_error, null};
+  }
+
+  // Used by the parsing constructors.
+  void check_parsed_request()
   {
     if (!rep_.IsObject())
       throw Error{Server_errc::invalid_request, null,
@@ -760,10 +803,6 @@ private:
 
     if (rep_.MemberCount() != expected_member_count)
       throw_invalid_request("unexpected member count");
-
-    DMITIGR_ASSERT(is_invariant_ok());
-  } catch (const rajson::Parse_exception&) {
-    throw Error{Server_errc::parse_error, null};
   }
 
   void init_notification(const std::string_view method)
@@ -88,12 +88,26 @@ public:
     return *this;
   }
 
-  /// @returns The expression of environment.
+  /// Removes the binding of the variable `name`, if any.
+  Env& unset(const std::string_view name) noexcept
+  {
+    const auto i = expr_iter(name);
+    if (i != cend(exprs_))
+      exprs_.erase(i);
+    return *this;
+  }
+
+  /**
+   * @returns The expression of environment.
+   *
+   * @remarks The binding is left intact, so the variable can be read
+   * repeatedly.
+   */
   Ret_expr expr(const std::string_view name) const noexcept
   {
     const auto i = expr_iter(name);
     if (i != cend(exprs_))
-      return std::move(i->second);
+      return Shared_expr{i->second};
     else
       return Err{Errc::var_unbound, std::string{name}};
   }
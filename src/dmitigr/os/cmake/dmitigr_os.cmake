@@ -36,6 +36,7 @@ set(dmitigr_os_headers
   error.hpp
   exceptions.hpp
   last_error.hpp
+  mmap.hpp
   pid.hpp
   types_fwd.hpp
   windows.hpp
@@ -0,0 +1,216 @@
+// -*- C++ -*-
+//
+// Copyright 2026 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DMITIGR_OS_MMAP_HPP
+#define DMITIGR_OS_MMAP_HPP
+
+#include "../base/noncopymove.hpp"
+#include "exceptions.hpp"
+
+#ifdef _WIN32
+#include "windows.hpp"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <filesystem>
+#include <utility>
+
+namespace dmitigr::os {
+
+/**
+ * @brief A private (copy-on-write) memory mapping of a regular file.
+ *
+ * @details The mapping is writable, but the modifications are not carried
+ * through to the underlying file. Thus, an in-place parser can scribble on
+ * the mapped bytes while the data is still read straight from the page cache
+ * with no intermediate buffer.
+ */
+class Mem_mapped_file final : private Noncopy {
+public:
+  /// The destructor.
+  ~Mem_mapped_file()
+  {
+    unmap();
+  }
+
+  /// The default-constructible. (Constructs invalid instance.)
+  Mem_mapped_file() = default;
+
+  /**
+   * @brief Maps the whole `file` into the address space of the process.
+   *
+   * @details One byte past the end of the file is included into the mapping
+   * whenever the operating system can guarantee it to read as zero, which
+   * makes the mapped data zero-terminated.
+   *
+   * @throws Sys_exception on failure.
+   *
+   * @see is_zero_terminated().
+   */
+  explicit Mem_mapped_file(const std::filesystem::path& file)
+  {
+#ifdef _WIN32
+    const HANDLE fh{::CreateFileW(file.wstring().c_str(), GENERIC_READ,
+      FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if (fh == INVALID_HANDLE_VALUE)
+      throw Sys_exception{"cannot open file "+file.string()};
+
+    LARGE_INTEGER file_size{};
+    if (!::GetFileSizeEx(fh, &file_size)) {
+      const auto ev = static_cast<int>(::GetLastError());
+      ::CloseHandle(fh);
+      throw Sys_exception{ev, "cannot get size of file "+file.string()};
+    }
+    size_ = static_cast<std::size_t>(file_size.QuadPart);
+
+    const HANDLE mh{::CreateFileMappingW(fh, nullptr, PAGE_WRITECOPY,
+      0, 0, nullptr)};
+    ::CloseHandle(fh);
+    if (!mh && size_)
+      throw Sys_exception{"cannot create mapping of file "+file.string()};
+
+    if (mh) {
+      data_ = static_cast<char*>(::MapViewOfFile(mh, FILE_MAP_COPY, 0, 0, 0));
+      ::CloseHandle(mh);
+      if (!data_)
+        throw Sys_exception{"cannot map view of file "+file.string()};
+    }
+    // The view is rounded up to the page size, so the trailing bytes of the
+    // last partial page read as zero.
+    is_zero_terminated_ = size_ % page_size();
+#else
+    const int fd{::open(file.c_str(), O_RDONLY|O_CLOEXEC)};
+    if (fd < 0)
+      throw Sys_exception{"cannot open file "+file.string()};
+
+    struct stat st{};
+    if (::fstat(fd, &st)) {
+      const int ev{errno};
+      ::close(fd);
+      throw Sys_exception{ev, "cannot get size of file "+file.string()};
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    if (size_) {
+      /*
+       * Map one byte beyond the end of the file: when the file size is not a
+       * multiple of the page size, the rest of the last page reads as zero,
+       * i.e. the mapped data is zero-terminated.
+       */
+      is_zero_terminated_ = size_ % page_size();
+      map_size_ = is_zero_terminated_ ? size_ + 1 : size_;
+      data_ = static_cast<char*>(::mmap(nullptr, map_size_,
+        PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0));
+      if (data_ == MAP_FAILED) {
+        const int ev{errno};
+        ::close(fd);
+        data_ = nullptr;
+        throw Sys_exception{ev, "cannot map file "+file.string()};
+      }
+#ifdef MADV_SEQUENTIAL
+      ::madvise(data_, map_size_, MADV_SEQUENTIAL|MADV_WILLNEED);
+#endif
+    }
+    ::close(fd);
+#endif  // _WIN32
+  }
+
+  /// Move-constructible.
+  Mem_mapped_file(Mem_mapped_file&& rhs) noexcept
+    : data_{rhs.data_}
+    , size_{rhs.size_}
+    , map_size_{rhs.map_size_}
+    , is_zero_terminated_{rhs.is_zero_terminated_}
+  {
+    rhs.data_ = nullptr;
+    rhs.size_ = rhs.map_size_ = 0;
+    rhs.is_zero_terminated_ = false;
+  }
+
+  /// Move-assignable.
+  Mem_mapped_file& operator=(Mem_mapped_file&& rhs) noexcept
+  {
+    Mem_mapped_file tmp{std::move(rhs)};
+    swap(tmp);
+    return *this;
+  }
+
+  /// Swaps this instance with the `other`.
+  void swap(Mem_mapped_file& other) noexcept
+  {
+    using std::swap;
+    swap(data_, other.data_);
+    swap(size_, other.size_);
+    swap(map_size_, other.map_size_);
+    swap(is_zero_terminated_, other.is_zero_terminated_);
+  }
+
+  /// @returns The mapped data, or `nullptr` if the mapped file is empty.
+  char* data() const noexcept
+  {
+    return data_;
+  }
+
+  /// @returns The size of the mapped file.
+  std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  /// @returns `true` if `data()[size()]` is guaranteed to be `'\0'`.
+  bool is_zero_terminated() const noexcept
+  {
+    return is_zero_terminated_;
+  }
+
+private:
+  char* data_{};
+  std::size_t size_{};
+  std::size_t map_size_{};
+  bool is_zero_terminated_{};
+
+  static std::size_t page_size() noexcept
+  {
+#ifdef _WIN32
+    SYSTEM_INFO info{};
+    ::GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+  }
+
+  void unmap() noexcept
+  {
+    if (data_) {
+#ifdef _WIN32
+      ::UnmapViewOfFile(data_);
+#else
+      ::munmap(data_, map_size_);
+#endif
+      data_ = nullptr;
+    }
+  }
+};
+
+} // namespace dmitigr::os
+
+#endif  // DMITIGR_OS_MMAP_HPP
@@ -23,6 +23,7 @@
 #include "exceptions.hpp"
 #include "ipc_pipe.hpp"
 #include "last_error.hpp"
+#include "mmap.hpp"
 #include "pid.hpp"
 #include "version.hpp"
 #ifdef _WIN32
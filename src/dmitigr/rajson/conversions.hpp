@@ -67,6 +67,27 @@ inline rapidjson::Document document_from_text(const std::string_view input)
   return result;
 }
 
+/**
+ * @returns The result of parsing a JSON text in place. (Aka in situ
+ * deserialization.)
+ *
+ * @details Unlike document_from_text(), decodes JSON strings directly into
+ * `input` rather than copying them into the DOM-owned storage.
+ *
+ * @par Requires
+ * `input` must be zero-terminated and must outlive the result.
+ *
+ * @throw Parse_exception on parse error.
+ */
+inline rapidjson::Document document_from_text_insitu(char* const input)
+{
+  rapidjson::Document result;
+  const rapidjson::ParseResult pr{result.ParseInsitu(input)};
+  if (!pr)
+    throw Parse_exception{pr};
+  return result;
+}
+
 /// @returns The RapidJSON's string reference.
 inline auto to_string_ref(const std::string_view value)
 {
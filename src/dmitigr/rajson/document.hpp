@@ -27,6 +27,7 @@
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 namespace dmitigr::rajson {
 
@@ -46,6 +47,26 @@ public:
       .append(std::to_string(e.parse_result().Offset()))};
   }
 
+  /**
+   * @brief Parses from `json` in place.
+   *
+   * @details Unlike the overload taking std::string_view, decodes JSON
+   * strings directly into the `json` buffer (which is retained by this
+   * instance) rather than copying every string value into the DOM-owned
+   * storage.
+   */
+  explicit Document(std::vector<char> json) try
+    : buf_{std::move(json)}
+  {
+    buf_.push_back('\0');
+    doc_ = rajson::document_from_text_insitu(buf_.data());
+    if (!doc_.IsNull() && !doc_.IsObject())
+      throw Exception{"invalid JSON input"};
+  } catch (const rajson::Parse_exception& e) {
+    throw Exception{std::string{"JSON parse error near position "}
+      .append(std::to_string(e.parse_result().Offset()))};
+  }
+
   /**
    * @brief Parses from `file`.
    *
@@ -64,6 +85,30 @@ public:
     swap(tmp);
   }
 
+  /**
+   * @returns A document parsed from the text `json` in place.
+   *
+   * @details Unlike the constructor taking std::vector<char>, the buffer is
+   * not retained: JSON strings are decoded directly into `json` and the DOM
+   * refers to them there.
+   *
+   * @par Requires
+   * `json` must be zero-terminated and must outlive the result.
+   */
+  static Document from_text_insitu(char* const json)
+  {
+    Document result;
+    try {
+      result.doc_ = rajson::document_from_text_insitu(json);
+    } catch (const rajson::Parse_exception& e) {
+      throw Exception{std::string{"JSON parse error near position "}
+        .append(std::to_string(e.parse_result().Offset()))};
+    }
+    if (!result.doc_.IsNull() && !result.doc_.IsObject())
+      throw Exception{"invalid JSON input"};
+    return result;
+  }
+
   /// Copy-constructible.
   Document(const Document& rhs) noexcept
   {
@@ -80,7 +125,8 @@ public:
 
   /// Move-constructible.
   Document(Document&& rhs) noexcept
-    : doc_{std::move(rhs.doc_)}
+    : buf_{std::move(rhs.buf_)}
+    , doc_{std::move(rhs.doc_)}
   {}
 
   /// Move-assignable.
@@ -95,6 +141,7 @@ public:
   void swap(Document& other) noexcept
   {
     using std::swap;
+    swap(buf_, other.buf_);
     swap(doc_, other.doc_);
   }
 
@@ -129,6 +176,7 @@ public:
   }
 
 private:
+  std::vector<char> buf_;
   rapidjson::Document doc_;
 };
 
@@ -37,13 +37,14 @@ set(dmitigr_web_headers
   )
 
 set(dmitigr_web_implementations
+  config.cpp
   )
 
 # ------------------------------------------------------------------------------
 # Dependencies
 # ------------------------------------------------------------------------------
 
-set(dmitigr_libs_web_deps base http jrpc lisp rajson tpl url ws)
+set(dmitigr_libs_web_deps base http jrpc lisp os rajson tpl url ws)
 
 # ------------------------------------------------------------------------------
 # Tests
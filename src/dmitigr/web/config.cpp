@@ -0,0 +1,106 @@
+// -*- C++ -*-
+//
+// Copyright 2026 Dmitry Igrishin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "../base/str.hpp"
+#include "../os/mmap.hpp"
+#include "../rajson/document.hpp"
+#include "config.hpp"
+#include "exceptions.hpp"
+#include "rajson.hpp"
+
+#include <utility>
+
+namespace dmitigr::web {
+
+DMITIGR_WEB_INLINE void Config::init_from_file(const std::filesystem::path& file)
+{
+  if (const os::Mem_mapped_file map{file}; map.is_zero_terminated())
+    init(rajson::Document::from_text_insitu(map.data()));
+  else
+    init(rajson::Document{file});
+}
+
+DMITIGR_WEB_INLINE void Config::init(const rajson::Document& cfg)
+{
+  /*
+   * Each sub-object is descended into only once here: a path-based
+   * cfg.get() per parameter would re-walk the DOM from the root.
+   */
+  const auto root = cfg.json();
+  const auto get = [](const auto& view, auto& dst, const std::string_view name,
+    const char* const node)
+  {
+    try {
+      view.get(dst, name);
+    } catch (const std::exception& e) {
+      throw Exception{std::string{"cannot get value of JSON node "}
+        .append(node).append(": ").append(e.what())};
+    }
+  };
+
+  // server.
+  {
+    const auto server = root.mandatory("server");
+
+    // server.host.
+    get(server, server_host_, "host", "server/host");
+    if (server_host_.empty() || str::has_ascii_space(server_host_))
+      throw Exception{"invalid server.host config parameter"};
+
+    // server.port.
+    get(server, server_port_, "port", "server/port");
+    if (server_port_ < 0 || server_port_ > 65535)
+      throw Exception{"invalid server.port config parameter"};
+
+    // server.ws.
+    const auto ws = server.mandatory("ws");
+    get(ws, server_ws_idle_timeout_,
+      "idleTimeout", "server/ws/idleTimeout");
+    get(ws, server_ws_max_incoming_payload_size_,
+      "maxIncomingPayloadSize", "server/ws/maxIncomingPayloadSize");
+    get(ws, server_ws_backpressure_buffer_size_,
+      "backpressureBufferSize", "server/ws/backpressureBufferSize");
+  }
+
+  // httper.docroot
+  std::string docroot;
+  get(root.mandatory("httper"), docroot, "docroot", "httper/docroot");
+  if (docroot.empty())
+    throw Exception{"invalid httper.docroot config parameter"};
+  httper_docroot_ = std::filesystem::path{std::move(docroot)};
+  httper_docroot_native_ = httper_docroot_.lexically_normal().generic_string();
+
+  // threadPoolSize.
+  get(root, thread_pool_size_, "threadPoolSize", "threadPoolSize");
+
+  // defaultLanguage.
+  get(root, default_language_, "defaultLanguage", "defaultLanguage");
+
+  // isBehindProxy.
+  get(root, is_behind_proxy_, "isBehindProxy", "isBehindProxy");
+
+  // The server options are built here once rather than on every call
+  // of server_options().
+  server_options_ = ws::Server_options{}
+    .set_http_enabled(true)
+    .set_host(server_host_)
+    .set_port(server_port_)
+    .set_ws_idle_timeout(server_ws_idle_timeout_)
+    .set_ws_max_incoming_payload_size(server_ws_max_incoming_payload_size_)
+    .set_ws_backpressure_buffer_size(server_ws_backpressure_buffer_size_);
+}
+
+} // namespace dmitigr::web
@@ -17,18 +17,20 @@
 #ifndef DMITIGR_WEB_CONFIG_HPP
 #define DMITIGR_WEB_CONFIG_HPP
 
-#include "../rajson/document.hpp"
 #include "../ws/server_options.hpp"
 #include "basics.hpp"
-#include "exceptions.hpp"
-#include "rajson.hpp"
+#include "dll.hpp"
 
-#include <algorithm>
-#include <filesystem>
-#include <cctype>
 #include <chrono>
 #include <cstdint>
+#include <filesystem>
+#include <optional>
 #include <string>
+#include <string_view>
+
+namespace dmitigr::rajson {
+class Document;
+} // namespace dmitigr::rajson
 
 namespace dmitigr::web {
 
@@ -44,6 +46,17 @@ public:
     return server_host_;
   }
 
+  /**
+   * @returns A value of "server.host" parameter as a borrowed view.
+   *
+   * @remarks Unlike server_host(), cannot be accidentally copied into a
+   * temporary std::string at the use site.
+   */
+  std::string_view server_host_sv() const noexcept
+  {
+    return server_host_;
+  }
+
   /// @returns A value of "server.port" parameter.
   int server_port() const noexcept
   {
@@ -74,6 +87,19 @@ public:
     return httper_docroot_;
   }
 
+  /**
+   * @returns A value of "httper.docroot" as a normalized generic-format
+   * string, cached upon init().
+   *
+   * @remarks Unlike `httper_docroot().string()`, involves neither an
+   * allocation nor an encoding conversion, and therefore is preferred
+   * on hot paths.
+   */
+  std::string_view httper_docroot_native() const noexcept
+  {
+    return httper_docroot_native_;
+  }
+
   /// @returns A value of "threadPoolSize" parameter.
   std::optional<std::uint32_t> thread_pool_size() const noexcept
   {
@@ -92,49 +118,29 @@ public:
     return is_behind_proxy_;
   }
 
-protected:
-  /// Deserializes the config.
-  void init(const rajson::Document& cfg)
+  /**
+   * @returns The server options built from the "server" parameters, cached
+   * upon init().
+   *
+   * @remarks Involves neither an allocation nor a copy.
+   */
+  const ws::Server_options& server_options() const noexcept
   {
-    using dmitigr::rajson::Path;
-
-    // server.host.
-    cfg.get(server_host_, Path{"server/host"});
-    if (server_host_.empty() || any_of(cbegin(server_host_),
-        cend(server_host_), [](const auto c){return std::isspace(c);}))
-      throw Exception{"invalid server.host config parameter"};
-
-    // server.port.
-    cfg.get(server_port_, Path{"server/port"});
-    if (server_port_ < 0 || server_port_ > 65535)
-      throw Exception{"invalid server.port config parameter"};
-
-    // server.ws.idleTimeout.
-    cfg.get(server_ws_idle_timeout_,
-      Path{"server/ws/idleTimeout"});
-
-    // server.ws.maxIncomingPayloadSize.
-    cfg.get(server_ws_max_incoming_payload_size_,
-      Path{"server/ws/maxIncomingPayloadSize"});
-
-    // server.ws.backpressureBufferSize.
-    cfg.get(server_ws_backpressure_buffer_size_,
-      Path{"server/ws/backpressureBufferSize"});
-
-    // httper.docroot
-    cfg.get(httper_docroot_, Path{"httper/docroot"});
-    if (httper_docroot_.empty())
-      throw Exception{"invalid httper.docroot config parameter"};
-
-    // threadPoolSize.
-    cfg.get(thread_pool_size_, Path{"threadPoolSize"});
+    return server_options_;
+  }
 
-    // defaultLanguage.
-    cfg.get(default_language_, Path{"defaultLanguage"});
+protected:
+  /**
+   * @brief Deserializes the config from `file`.
+   *
+   * @details Maps `file` copy-on-write and parses it in place, straight from
+   * the page cache: no intermediate buffer is allocated and no string value
+   * is copied into the DOM-owned storage.
+   */
+  DMITIGR_WEB_API void init_from_file(const std::filesystem::path& file);
 
-    // isBehindProxy.
-    cfg.get(is_behind_proxy_, Path{"isBehindProxy"});
-  }
+  /// Deserializes the config.
+  DMITIGR_WEB_API void init(const rajson::Document& cfg);
 
 private:
   std::string server_host_;
@@ -143,23 +149,23 @@ private:
   std::uint32_t server_ws_max_incoming_payload_size_{};
   std::uint32_t server_ws_backpressure_buffer_size_{};
   std::filesystem::path httper_docroot_;
+  std::string httper_docroot_native_;
   std::optional<std::uint32_t> thread_pool_size_{};
   Language default_language_;
   bool is_behind_proxy_{};
+  ws::Server_options server_options_;
 };
 
 /// @returns A server options from `cfg`.
-inline ws::Server_options server_options(const Config& cfg)
+inline const ws::Server_options& server_options(const Config& cfg) noexcept
 {
-  return ws::Server_options{}
-    .set_http_enabled(true)
-    .set_host(cfg.server_host())
-    .set_port(cfg.server_port())
-    .set_ws_idle_timeout(cfg.server_ws_idle_timeout())
-    .set_ws_max_incoming_payload_size(cfg.server_ws_max_incoming_payload_size())
-    .set_ws_backpressure_buffer_size(cfg.server_ws_backpressure_buffer_size());
+  return cfg.server_options();
 }
 
 } // namespace dmitigr::web
 
+#ifndef DMITIGR_WEB_NOT_HEADER_ONLY
+#include "config.cpp"
+#endif
+
 #endif  // DMITIGR_WEB_CONFIG_HPP
@@ -59,27 +59,40 @@ enum class Errc {
  */
 constexpr const char* to_literal(const Errc errc) noexcept
 {
-  switch (errc) {
-  case Errc::service_not_ready:
-    return "service_not_ready";
-
-  case Errc::lisp_expr_not_tpl:
-    return "lisp_expr_not_tpl";
-  case Errc::lisp_expr_not_tplstack:
-    return "lisp_expr_not_tplstack";
-
-  case Errc::file_not_found:
-    return "file_not_found";
-
-  case Errc::tpl_cycle:
-    return "tpl_cycle";
-
-  case Errc::txt_invalid:
-    return "txt_invalid";
-  }
-  return nullptr;
+  /*
+   * A perfect hash over the values of Errc: two ALU operations plus a load
+   * instead of a chain of compares over a sparse key set. The multiplier is
+   * chosen so that every enumerator lands in a distinct bucket, which is
+   * enforced by the static_assert below.
+   */
+  struct Entry final {
+    unsigned code{};
+    const char* literal{};
+  };
+  constexpr unsigned multiplier{0x414c343du};
+  constexpr Entry table[8]{
+    {40111, "tpl_cycle"},
+    {20011, "lisp_expr_not_tpl"},
+    {50011, "txt_invalid"},
+    {10011, "service_not_ready"},
+    {},
+    {20021, "lisp_expr_not_tplstack"},
+    {},
+    {30011, "file_not_found"}
+  };
+  const auto value = static_cast<unsigned>(errc);
+  const auto& entry = table[(value * multiplier) >> 29];
+  return entry.code == value ? entry.literal : nullptr;
 }
 
+static_assert(to_literal(Errc::service_not_ready)
+  && to_literal(Errc::lisp_expr_not_tpl)
+  && to_literal(Errc::lisp_expr_not_tplstack)
+  && to_literal(Errc::file_not_found)
+  && to_literal(Errc::tpl_cycle)
+  && to_literal(Errc::txt_invalid),
+  "the hash of to_literal(Errc) is not perfect");
+
 /**
  * @returns The literal returned by `to_literal(errc)`, or literal
  * `unknown error` if `to_literal(errc)` returned `nullptr`.
@@ -19,8 +19,14 @@
 
 #include "errc.hpp"
 
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <string>
+#include <string_view>
 #include <system_error>
 #include <type_traits> // true_type
+#include <utility>
 
 namespace std {
 
@@ -60,12 +66,41 @@ public:
    */
   std::string message(const int ev) const override
   {
-    const char* const desc{to_literal_anyway(static_cast<Errc>(ev))};
-    constexpr const char* const sep{": "};
-    std::string result;
-    result.reserve(std::strlen(name()) + std::strlen(sep) + std::strlen(desc));
-    return result.append(name()).append(sep).append(desc);
+    // The strings are built once: subsequent calls only copy them.
+    std::call_once(init_flag_, [this]
+    {
+      std::transform(std::cbegin(message_texts_), std::cend(message_texts_),
+        begin(messages_), [](const auto& text)
+        {
+          return std::string{text.second};
+        });
+    });
+    const auto e = std::cend(message_texts_);
+    const auto i = std::lower_bound(std::cbegin(message_texts_), e, ev,
+      [](const auto& message, const int value)
+      {
+        return message.first < value;
+      });
+    if (i != e && i->first == ev)
+      return messages_[i - std::cbegin(message_texts_)];
+    return std::string{"dmitigr_web_generic_error: unknown error"};
   }
+
+private:
+  /// The prebuilt message texts sorted by the error code.
+  constexpr static std::pair<int, std::string_view> message_texts_[]{
+    {10011, "dmitigr_web_generic_error: service_not_ready"},
+    {20011, "dmitigr_web_generic_error: lisp_expr_not_tpl"},
+    {20021, "dmitigr_web_generic_error: lisp_expr_not_tplstack"},
+    {30011, "dmitigr_web_generic_error: file_not_found"},
+    {40111, "dmitigr_web_generic_error: tpl_cycle"},
+    {50011, "dmitigr_web_generic_error: txt_invalid"}
+  };
+  static_assert(std::is_sorted(std::cbegin(message_texts_),
+    std::cend(message_texts_)));
+
+  mutable std::once_flag init_flag_;
+  mutable std::array<std::string, std::size(message_texts_)> messages_;
 };
 
 /**
@@ -18,6 +18,7 @@
 #define DMITIGR_WEB_HTTP_HPP
 
 #include "../base/assert.hpp"
+#include "../base/function.hpp"
 #include "../base/log.hpp"
 #include "../base/str.hpp"
 #include "../base/stream.hpp"
@@ -38,7 +39,10 @@
 #include "util.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <functional>
@@ -48,6 +52,7 @@
 #include <shared_mutex>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -57,108 +62,238 @@ namespace dmitigr::web {
 // Helpers
 // -----------------------------------------------------------------------------
 
-/// @returns `true` if `reqpath` is valid.
+/**
+ * @returns `true` if `reqpath` is valid, i.e. starts with `/` and consists
+ * only of ASCII alphanumerics, `-`, `_`, `.` and `/`.
+ *
+ * @remarks Classifies 8-byte chunks branch-free (SWAR) rather than calling
+ * the locale-aware std::isalnum() per byte.
+ */
 inline bool is_valid_request_path(const std::string_view reqpath) noexcept
 {
-  return !reqpath.empty() &&
-    reqpath.front() == '/' &&
-    std::all_of(cbegin(reqpath) + 1, cend(reqpath), [](const unsigned char c)
-    {
-      return std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '/';
-    });
+  if (reqpath.empty() || reqpath.front() != '/')
+    return false;
+
+  constexpr std::uint64_t ones{0x0101010101010101ull};
+  constexpr std::uint64_t highs{0x8080808080808080ull};
+  // @returns The word with 0x80 set in every lane of ['lo', 'hi']. (ASCII `x`.)
+  constexpr auto in_range = [](const std::uint64_t x,
+    const char lo, const char hi) noexcept
+  {
+    return (x + (0x80 - lo) * ones) & ~(x + (0x80 - hi - 1) * ones) & highs;
+  };
+  // @returns The word with 0x80 set in every lane which equals `ch`. (Exact.)
+  constexpr auto eq = [](const std::uint64_t x, const char ch) noexcept
+  {
+    const auto v = x ^ (static_cast<std::uint64_t>(
+      static_cast<unsigned char>(ch)) * ones);
+    return ~(((v & ~highs) + ~highs) | v | ~highs);
+  };
+
+  const char* ptr{reqpath.data() + 1};
+  auto size = reqpath.size() - 1;
+  for (; size >= 8; ptr += 8, size -= 8) {
+    std::uint64_t x;
+    std::memcpy(&x, ptr, 8);
+    const auto ascii = x & ~highs;
+    const auto valid = (in_range(ascii, 'a', 'z') | in_range(ascii, 'A', 'Z') |
+      in_range(ascii, '0', '9') | eq(x, '-') | eq(x, '_') | eq(x, '.') |
+      eq(x, '/')) & ~x & highs;
+    if (valid != highs)
+      return false;
+  }
+  for (; size; ++ptr, --size) {
+    const char ch{*ptr};
+    if (!(('a' <= ch && ch <= 'z') || ('A' <= ch && ch <= 'Z') ||
+        ('0' <= ch && ch <= '9') ||
+        ch == '-' || ch == '_' || ch == '.' || ch == '/'))
+      return false;
+  }
+  return true;
 }
 
-/// The vector of pairs of extensions with counterparts.
-inline const std::vector<std::pair<std::string_view, std::string_view>> tpl_extensions{
+/**
+ * @returns The normalized generic-format form of `reqpath`: redundant
+ * separators and dot segments are collapsed, dot-dot segments are resolved
+ * without escaping the root, the trailing separator is kept for directory
+ * requests.
+ *
+ * @par Requires
+ * `is_valid_request_path(reqpath)`.
+ *
+ * @remarks Behaves as `path{reqpath}.lexically_normal().generic_string()`
+ * but in a single pass, with a single allocation and no std::filesystem
+ * machinery involved.
+ */
+inline std::string normalized_request_path(const std::string_view reqpath)
+{
+  std::string result;
+  result.reserve(reqpath.size() + 1);
+  result += '/';
+  bool is_dir{true};
+  const auto size = reqpath.size();
+  for (std::string_view::size_type i{1}; i < size;) {
+    auto j = reqpath.find('/', i);
+    if (j == std::string_view::npos)
+      j = size;
+    const auto seg = reqpath.substr(i, j - i);
+    if (seg.empty() || seg == ".")
+      is_dir = true;
+    else if (seg == "..") {
+      // Pop the last segment without escaping the root.
+      if (result.size() > 1) {
+        result.pop_back();
+        result.resize(result.find_last_of('/') + 1);
+      }
+      is_dir = true;
+    } else {
+      result.append(seg) += '/';
+      is_dir = false;
+    }
+    i = j + 1;
+  }
+  if (!is_dir && reqpath.back() != '/')
+    result.pop_back();
+  return result;
+}
+
+/// The array of pairs of extensions with counterparts.
+constexpr std::array<std::pair<std::string_view, std::string_view>, 6>
+tpl_extensions{{
   {".html", ".thtml"},
   {".css", ".tcss"},
   {".js", ".tjs"},
   {".json", ".tjson"},
   {".xml", ".txml"},
   {".txt", ".ttxt"}
-};
+}};
+
+/**
+ * @returns The extension of `fname` (with the leading dot), or an empty view.
+ *
+ * @remarks Behaves as `path{fname}.extension()` (dotfiles and the special
+ * `.`/`..` names have no extension) but without constructing a path.
+ */
+inline std::string_view extension_view(const std::string_view fname) noexcept
+{
+  if (fname == "." || fname == "..")
+    return {};
+  const auto pos = fname.rfind('.');
+  return pos == std::string_view::npos || !pos ?
+    std::string_view{} : fname.substr(pos);
+}
 
 /// @returns `true` if `ext` represents a template filename extension.
-inline bool is_tpl_extension(const std::filesystem::path& ext) noexcept
+inline bool is_tpl_extension(const std::string_view ext) noexcept
 {
   return !ext.empty() && any_of(cbegin(tpl_extensions), cend(tpl_extensions),
-    [&ext](const auto& x){return ext == x.second;});
+    [ext](const auto& x){return ext == x.second;});
 }
 
 /**
- * @returns Template filename extension, promoted from `ext`, or empty path if
- * no such a promotion possible.
+ * @returns Template filename extension, promoted from `ext`, or an empty
+ * view if no such a promotion possible.
  */
-inline std::filesystem::path to_tpl_extension(const std::filesystem::path& ext)
+inline std::string_view to_tpl_extension(const std::string_view ext) noexcept
 {
-  using std::filesystem::path;
   if (ext.empty())
-    return ext;
+    return {};
   const auto b = cbegin(tpl_extensions);
   const auto e = cend(tpl_extensions);
-  const auto i = find_if(b, e, [&ext](const auto& x){return ext == x.first;});
-  return i != e ? path{i->second} : path{};
+  const auto i = find_if(b, e, [ext](const auto& x){return ext == x.first;});
+  return i != e ? i->second : std::string_view{};
 }
 
 /// @returns The value of the `Content-Type` header by `fname`.
 inline std::string_view content_type(const std::filesystem::path& fname) noexcept
 {
-  if (const auto ext = fname.extension(); ext.empty())
-    return "application/octet-stream";
-  else if (ext == ".html" || ext == ".thtml")
-    return "text/html";
-  else if (ext == ".css" || ext == ".tcss")
-    return "text/css";
-  else if (ext == ".js" || ext == ".tjs")
-    return "application/javascript";
-  else if (ext == ".json" || ext == ".tjson")
-    return "application/json";
-  else if (ext == ".xml" || ext == ".txml")
-    return "text/xml";
-  else if (ext == ".txt" || ext == ".ttxt")
-    return "text/plain";
-  else if (ext == ".ico")
-    return "image/x-icon";
-  else if (ext == ".png")
-    return "image/png";
-  else if (ext == ".jpeg" || ext == ".jpg")
-    return "image/jpeg";
-  else if (ext == ".gif")
-    return "image/gif";
-  else if (ext == ".svg" || ext == ".svgz")
-    return "image/svg+xml";
-  else if (ext == ".pdf")
-    return "application/pdf";
-  else if (ext == ".ods")
-    return "application/vnd.oasis.opendocument.spreadsheet";
-  else if (ext == "odt")
-    return "application/vnd.oasis.opendocument.text";
-  else if (ext == ".7z")
-    return "application/x-7z-compressed";
-  else if (ext == ".zip")
-    return "application/zip";
-  else if (ext == ".mp3")
-    return "audio/mpeg";
-  else if (ext == ".ogg")
-    return "audio/ogg";
-  else if (ext == ".m4a")
-    return "audio/x-m4a";
-  else if (ext == ".mp4")
-    return "video/mp4";
-  else if (ext == ".mpeg" || ext == ".mpg")
-    return "video/mpeg";
-  else if (ext == ".mov")
-    return "video/quicktime";
-  else if (ext == ".flv")
-    return "video/x-flv";
-  else if (ext == ".m4v")
-    return "video/x-m4v";
-  else if (ext == ".wmv")
-    return "video/x-ms-wmv";
-  else if (ext == ".avi")
-    return "video/x-msvideo";
-  else
-    return "application/octet-stream";
+  // The known extensions with content types sorted by the extension.
+  constexpr std::pair<std::string_view, std::string_view> types[]{
+    {".7z", "application/x-7z-compressed"},
+    {".avi", "video/x-msvideo"},
+    {".css", "text/css"},
+    {".flv", "video/x-flv"},
+    {".gif", "image/gif"},
+    {".html", "text/html"},
+    {".ico", "image/x-icon"},
+    {".jpeg", "image/jpeg"},
+    {".jpg", "image/jpeg"},
+    {".js", "application/javascript"},
+    {".json", "application/json"},
+    {".m4a", "audio/x-m4a"},
+    {".m4v", "video/x-m4v"},
+    {".mov", "video/quicktime"},
+    {".mp3", "audio/mpeg"},
+    {".mp4", "video/mp4"},
+    {".mpeg", "video/mpeg"},
+    {".mpg", "video/mpeg"},
+    {".ods", "application/vnd.oasis.opendocument.spreadsheet"},
+    {".odt", "application/vnd.oasis.opendocument.text"},
+    {".ogg", "audio/ogg"},
+    {".pdf", "application/pdf"},
+    {".png", "image/png"},
+    {".svg", "image/svg+xml"},
+    {".svgz", "image/svg+xml"},
+    {".tcss", "text/css"},
+    {".thtml", "text/html"},
+    {".tjs", "application/javascript"},
+    {".tjson", "application/json"},
+    {".ttxt", "text/plain"},
+    {".txml", "text/xml"},
+    {".txt", "text/plain"},
+    {".wmv", "video/x-ms-wmv"},
+    {".xml", "text/xml"},
+    {".zip", "application/zip"}
+  };
+  static_assert(std::is_sorted(std::cbegin(types), std::cend(types)));
+  constexpr std::string_view fallback{"application/octet-stream"};
+
+  /*
+   * Find the extension bytes right in the native representation: unlike
+   * path::extension(), involves no allocation.
+   */
+  const auto& native = fname.native();
+  const auto pos = [&native]
+  {
+    constexpr auto npos = std::decay_t<decltype(native)>::npos;
+    for (auto i = native.size(); i > 0; --i) {
+      const auto ch = native[i - 1];
+      if (ch == '.') {
+        // A filename beginning with a dot has no extension.
+        if (i == 1)
+          break;
+        const auto prev = native[i - 2];
+        if (prev == '/' || prev == std::filesystem::path::preferred_separator)
+          break;
+        return i - 1;
+      } else if (ch == '/' || ch == std::filesystem::path::preferred_separator)
+        break;
+    }
+    return npos;
+  }();
+  if (pos == std::decay_t<decltype(native)>::npos)
+    return fallback;
+
+  // The longest known extension is 6 characters.
+  char ext[8];
+  const auto size = native.size() - pos;
+  if (size >= sizeof(ext))
+    return fallback;
+  for (std::size_t i{}; i < size; ++i) {
+    const auto ch = native[pos + i];
+    if (ch <= 0 || ch > 127)
+      return fallback;
+    ext[i] = static_cast<char>(ch);
+  }
+
+  const std::string_view key{ext, size};
+  const auto e = std::cend(types);
+  const auto i = std::lower_bound(std::cbegin(types), e, key,
+    [](const auto& type, const std::string_view k)
+    {
+      return type.first < k;
+    });
+  return i != e && i->first == key ? i->second : fallback;
 }
 
 // -----------------------------------------------------------------------------
@@ -177,13 +312,34 @@ inline bool send_error(std::shared_ptr<ws::Http_io> io,
     if (!io || !io->is_valid())
       throw Exception{"cannot send error: invalid IO"};
 
-    const auto phrase = to_literal_anyway(status);
-    const auto content = std::string{"<!doctype html><html><title>"}
-      .append(phrase).append("</title>")
-      .append("<body><h1>").append(phrase).append("</h1></body></html>");
-    io->send_status(status);
-    io->send_header("Content-Type", "text/html");
-    io->end(content);
+    /*
+     * The set of statuses is bounded and known, so the complete pages are
+     * built once upon the first call instead of being concatenated (with
+     * heap traffic) on every error response. The slot of index 0 keeps the
+     * page for statuses unknown to http::Server_errc.
+     */
+    static const auto pages = []
+    {
+      const auto page = [](const std::string_view phrase)
+      {
+        return std::string{"<!doctype html><html><title>"}
+          .append(phrase).append("</title>")
+          .append("<body><h1>").append(phrase).append("</h1></body></html>");
+      };
+      std::array<std::string, 600> result;
+      for (int code{100}; code < 600; ++code) {
+        if (const char* const phrase =
+          to_literal(static_cast<http::Server_errc>(code)))
+          result[static_cast<std::size_t>(code)] = page(phrase);
+      }
+      result[0] = page(to_literal_anyway(static_cast<http::Server_errc>(0)));
+      return result;
+    }();
+
+    const auto index = static_cast<std::size_t>(status);
+    const auto& content = index < pages.size() && !pages[index].empty() ?
+      pages[index] : pages[0];
+    io->respond(status, {{"Content-Type", "text/html"}}, content);
     return true;
   } catch (const std::exception& e) {
     log::error("HTTP: send error: {}", e.what());
@@ -197,21 +353,27 @@ inline bool send_error(std::shared_ptr<ws::Http_io> io,
 /**
  * @brief Sends the data.
  *
+ * @param owner An optional holder of the storage `data` refers to, retained
+ * for the duration of the send.
+ *
  * @returns `true` on success.
  *
+ * @remarks Unlike the former by-value signature, accepting a view spares the
+ * callers with static or shared bodies from an allocation plus a copy.
+ *
  * @todo Handle backpressure.
  */
 inline bool send_data(std::shared_ptr<ws::Http_io> io,
-  std::string data,
-  const std::string_view content_type) noexcept
+  const std::string_view data,
+  const std::string_view content_type,
+  const std::shared_ptr<void> owner = {}) noexcept
 {
+  (void)owner;
   try {
     if (!io)
       throw Exception{"cannot send data: invalid IO"};
 
-    io->send_status(http::Server_errc::ok);
-    io->send_header("Content-Type", content_type);
-    io->end(data);
+    io->respond(http::Server_errc::ok, {{"Content-Type", content_type}}, data);
     return true;
   } catch (const std::exception& e) {
     log::error("HTTP: send data: {}", e.what());
@@ -225,75 +387,64 @@ inline bool send_data(std::shared_ptr<ws::Http_io> io,
 /**
  * @brief Sends the specified file.
  *
+ * @param type A value of the `Content-Type` header. Empty value means
+ * "resolve from `fname`".
+ *
  * @return `true` on success.
  */
 inline bool send_file(std::shared_ptr<ws::Http_io> io,
   const std::filesystem::path& fname,
-  const bool is_attachment) noexcept
+  const bool is_attachment,
+  const std::string_view type = {}) noexcept
 {
   try {
     if (!io)
       throw Exception{"cannot send file: invalid IO"};
 
-    // Make the input stream.
-    const auto in = std::make_shared<std::ifstream>(fname);
-    if (!in->good())
-      return send_error(io, http::Server_errc::internal_server_error);
-
-    // Get the file size.
-    using std::ios_base;
-    in->seekg(0, ios_base::end);
-    const auto file_size = in->tellg();
-    in->seekg(0, ios_base::beg);
-
-    constexpr std::size_t send_buffer_size{128 * 1024};
-    io->set_send_handler([io, in, file_size](const std::uintmax_t pos) -> bool
+    /*
+     * Map the file instead of streaming it through an intermediate buffer:
+     * the content is sent as views straight into the page cache, with no
+     * user-space copy per chunk. Neither a sendfile(2)-style descriptor
+     * hand-off nor an io_uring SPLICE chain is expressible through the
+     * ws::Http_io abstraction: the underlying library owns the socket and
+     * its event loop, so the per-chunk socket writes stay with it.
+     */
+    const auto map = [&fname]() -> std::shared_ptr<os::Mem_mapped_file>
     {
-      // badbit shouldn't be possible here, but check it just in case.
-      if (in->bad()) {
-        log::error("HTTP: send file: badbit input file stream");
-        io->abort();
-        return true;
+      try {
+        return std::make_shared<os::Mem_mapped_file>(fname);
+      } catch (const std::exception& e) {
+        log::error("HTTP: send file: {}", e.what());
+        return nullptr;
       }
+    }();
+    if (!map)
+      return send_error(io, http::Server_errc::internal_server_error);
 
-      /*
-       * failbit is possible when the stream is done (std::basic_ios::eof() is
-       * `true`) but not all the data sent (the last call of Http_io::send_data()
-       * returned `{false, false}`).
-       */
-      in->clear();
-
-      in->seekg(pos, std::ios_base::beg);
+    const auto file_size = static_cast<std::uintmax_t>(map->size());
+    const auto send_from = [io, map, file_size](std::uintmax_t pos) -> bool
+    {
+      constexpr std::uintmax_t send_chunk_size{128 * 1024};
       while (true) {
-        char buf[send_buffer_size];
-        in->read(buf, sizeof(buf));
-        const auto gcount =
-          static_cast<std::string_view::size_type>(in->gcount());
-        const auto [ok, done] =
-          io->send_content(std::string_view{buf, gcount}, file_size);
+        const auto count = std::min(file_size - pos, send_chunk_size);
+        const auto [ok, done] = io->send_content(std::string_view{
+          map->data() + pos,
+          static_cast<std::string_view::size_type>(count)}, file_size);
         if (!ok || done)
           return ok;
+        pos += count;
       }
-      DMITIGR_ASSERT(false);
-    });
+    };
+    io->set_send_handler(send_from);
 
     // Send headers.
-    io->send_header("Content-Type", content_type(fname));
+    io->send_header("Content-Type", !type.empty() ? type : content_type(fname));
     if (is_attachment)
       io->send_header("Content-Disposition", std::string{"attachment; filename="}
         .append(fname.filename().string()));
 
     // Send the initial part of content.
-    while (true) {
-      char buf[send_buffer_size];
-      in->read(buf, sizeof(buf));
-      const auto gcount =
-        static_cast<std::string_view::size_type>(in->gcount());
-      const auto [ok, done] =
-        io->send_content(std::string_view{buf, gcount}, file_size);
-      if (!ok || done)
-        break;
-    }
+    send_from(0);
     return true;
   } catch (const std::exception& e) {
     log::error("HTTP: send file: {}", e.what());
@@ -304,6 +455,50 @@ inline bool send_file(std::shared_ptr<ws::Http_io> io,
   }
 }
 
+// -----------------------------------------------------------------------------
+// Stat cache
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A bounded TTL cache of std::filesystem::is_regular_file() results.
+ *
+ * @details An existence check is a stat(2) syscall, and serving a static
+ * asset involves up to several of them; for hot assets these dominate. The
+ * entries expire after 1 second, so a created or deleted file is noticed
+ * with at most that delay.
+ */
+class Stat_cache final {
+public:
+  /// @returns `true` if `path` is a regular file.
+  bool is_regular_file(const std::filesystem::path& path)
+  {
+    const auto now = std::chrono::steady_clock::now();
+    {
+      const std::shared_lock lg{mutex_};
+      if (const auto i = map_.find(path.native());
+        i != cend(map_) && now < i->second.expiry)
+        return i->second.is_regular;
+    }
+    const bool result{std::filesystem::is_regular_file(path)};
+    const std::lock_guard lg{mutex_};
+    if (map_.size() >= max_size)
+      map_.clear();
+    map_.insert_or_assign(path.native(), Entry{result, now + ttl});
+    return result;
+  }
+
+private:
+  struct Entry final {
+    bool is_regular{};
+    std::chrono::steady_clock::time_point expiry;
+  };
+
+  constexpr static std::size_t max_size{1024};
+  constexpr static std::chrono::milliseconds ttl{1000};
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::filesystem::path::string_type, Entry> map_;
+};
+
 // -----------------------------------------------------------------------------
 // HTTP request handler
 // -----------------------------------------------------------------------------
@@ -322,34 +517,185 @@ public:
     Language language;
     std::string method;
     std::string path;
-    std::smatch path_smatch;
+    /**
+     * The submatches refer directly into `path`, which is stable for the
+     * whole lifetime of the request.
+     */
+    std::cmatch path_smatch;
     std::string body;
     std::string content_type;
     std::filesystem::path filepath;
     std::filesystem::path filename;
+    /**
+     * The value of the `Content-Type` response header, resolved from
+     * `filename` once upon Httper::handle().
+     */
+    std::string_view content_type_cached;
     url::Query_string query_string;
-    http::Cookie cookie;
+    /// The raw value of the `Cookie` request header.
+    std::string cookie_header;
     /**
      * Extracted directly from HTTP request, or from "x-remote-ip-address"
      * header if Httper::is_behind_proxy().
      */
     net::Ip_address remote_ip_address;
+
+    /**
+     * @returns The cookies, parsed from `cookie_header` upon the first call.
+     *
+     * @remarks Most requests don't need the parsed cookies at all: a single
+     * cookie can be picked from `cookie_header` with http::Cookie::find()
+     * without parsing (and allocating) every entry.
+     */
+    const http::Cookie& cookie() const
+    {
+      if (!cookie_)
+        cookie_.emplace(cookie_header);
+      return *cookie_;
+    }
+
+    /**
+     * @brief Resets the instance to the freshly constructed state.
+     *
+     * @remarks The capacities of the dynamic members are preserved, which
+     * makes the instance suitable for pooling.
+     */
+    void clear()
+    {
+      account_id = {};
+      language = {};
+      method.clear();
+      path.clear();
+      path_smatch = {};
+      body.clear();
+      content_type.clear();
+      filepath.clear();
+      filename.clear();
+      content_type_cached = {};
+      query_string = url::Query_string{};
+      cookie_header.clear();
+      cookie_.reset();
+      remote_ip_address = {};
+    }
+
+  private:
+    mutable std::optional<http::Cookie> cookie_;
+  };
+
+  /**
+   * @brief A compiled route pattern.
+   *
+   * @details When the pattern contains no regex metacharacters it is matched
+   * by a plain (case-insensitive) string comparison: the regex engine runs
+   * only on the route that actually won, and only to fill the capture groups.
+   * Likewise, a pattern which is a literal followed by a trailing `.*` (the
+   * most common shape of a public route, e.g. `/auth/.*`) is matched by a
+   * plain prefix comparison.
+   */
+  class Route final {
+  public:
+    /// Compiles the route from a regex.
+    Route(std::regex regex)
+      : regex_{std::move(regex)}
+    {}
+
+    /// Compiles the route from a pattern string.
+    Route(const std::string& pattern)
+      : pattern_{pattern}
+      , regex_{pattern,
+        std::regex::ECMAScript|std::regex::icase|std::regex::optimize}
+    {
+      constexpr const char* const metacharacters{R"(.^$|()[]{}*+?\)"};
+      const auto meta = pattern.find_first_of(metacharacters);
+      if (meta == std::string::npos)
+        literal_ = str::to_lowercase(pattern);
+      else if (meta && meta == pattern.size() - 2 && pattern.ends_with(".*"))
+        prefix_ = str::to_lowercase(pattern.substr(0, meta));
+    }
+
+    /// @returns `true` if `path` matches this route.
+    bool matches(const std::string& path) const
+    {
+      if (literal_)
+        return path == *literal_;
+      else if (prefix_)
+        return std::string_view{path}.starts_with(*prefix_);
+      else
+        return std::regex_match(path, regex_);
+    }
+
+    /**
+     * @brief The overload which fills `sm` upon match.
+     *
+     * @details On a literal or prefix route the regex engine is only involved
+     * when the cheap string comparison succeeded.
+     *
+     * @remarks `sm` is a std::cmatch, so the filled submatches refer into
+     * `path` directly and the consumers need no copies of it.
+     */
+    bool matches(const std::string& path, std::cmatch& sm) const
+    {
+      if (literal_ && path != *literal_)
+        return false;
+      else if (prefix_ && !std::string_view{path}.starts_with(*prefix_))
+        return false;
+      return std::regex_match(path.data(), path.data() + path.size(),
+        sm, regex_);
+    }
+
+    /// @returns `true` if this route is matched by a plain string comparison.
+    bool is_literal() const noexcept
+    {
+      return literal_.has_value();
+    }
+
+    /// @returns `true` if this route is matched by a plain prefix comparison.
+    bool is_prefix() const noexcept
+    {
+      return prefix_.has_value();
+    }
+
+    /**
+     * @returns The lowercased literal this route is matched by, or
+     * `std::nullopt` if `!is_literal()`.
+     */
+    const std::optional<std::string>& literal() const noexcept
+    {
+      return literal_;
+    }
+
+    /**
+     * @returns The pattern string this route was compiled from, or
+     * `std::nullopt` if the route was constructed from a prebuilt regex.
+     */
+    const std::optional<std::string>& pattern() const noexcept
+    {
+      return pattern_;
+    }
+
+  private:
+    std::optional<std::string> literal_;
+    std::optional<std::string> prefix_;
+    std::optional<std::string> pattern_;
+    std::regex regex_;
   };
 
   /// The alias of a text template handler (tpler).
-  using Tpler = std::function<void(tpl::Generic&, const Request&)>;
+  using Tpler = Inplace_function<void(tpl::Generic&, const Request&)>;
 
   /// The alias of a RPC handler (rpcer).
-  using Rpcer = std::function<jrpc::Result(const jrpc::Request&, const Request&)>;
+  using Rpcer =
+    Inplace_function<jrpc::Result(const jrpc::Request&, const Request&)>;
 
   /// The alias of a generic handler (gener).
-  using Gener = std::function<void(std::shared_ptr<ws::Http_io>, const Request&)>;
+  using Gener =
+    Inplace_function<void(std::shared_ptr<ws::Http_io>, const Request&)>;
 
-  /// The alias of a `{regex, tpler}` pair.
-  using Regex_tpler_pair = std::pair<std::regex, Tpler>;
+  /// The alias of a `{route, tpler}` pair.
+  using Regex_tpler_pair = std::pair<Route, Tpler>;
 
-  /// The alias of a `{regex, rpcer}` pair.
-  using Regex_rpcer_pair = std::pair<std::regex, Rpcer>;
+  /// The alias of a `{route, rpcer}` pair.
+  using Regex_rpcer_pair = std::pair<Route, Rpcer>;
 
   /**
    * @brief The alias of the function which is called if the current request
@@ -360,7 +706,7 @@ public:
    *
    * @see Auth_prompter, publics().
    */
-  using Auth_checker = std::function<std::int_fast64_t(const Request&)>;
+  using Auth_checker = Inplace_function<std::int_fast64_t(const Request&)>;
 
   /**
    * @brief The alias of the function which generates the prompt for
@@ -376,7 +722,7 @@ public:
    *
    * @see Auth_checker.
    */
-  using Auth_prompter = std::function<std::string()>;
+  using Auth_prompter = Inplace_function<std::string()>;
 
   /// Not copy-constructible.
   Httper(const Httper&) = delete;
@@ -434,6 +780,8 @@ public:
   Httper& set_docroot(std::filesystem::path value)
   {
     docroot_ = std::move(value);
+    docroot_expr_ = lisp::make_expr<Path_expr>(docroot_);
+    publish();
     return *this;
   }
 
@@ -445,7 +793,7 @@ public:
    * @warning The mutex() must be locked before calling this function and till
    * the end of working with the returned value!
    */
-  const std::vector<std::regex>& publics() const noexcept
+  const std::vector<Route>& publics() const noexcept
   {
     return publics_;
   }
@@ -459,15 +807,17 @@ public:
    */
   Httper& add_public(std::regex value)
   {
-    publics_.push_back(std::move(value));
+    publics_.emplace_back(std::move(value));
+    publish();
     return *this;
   }
 
   /// @overload
   Httper& add_public(const std::string& value)
   {
-    using re = std::regex;
-    publics_.emplace_back(value, re::ECMAScript|re::icase|re::optimize);
+    publics_.emplace_back(value);
+    rebuild_public_alternation();
+    publish();
     return *this;
   }
 
@@ -476,9 +826,26 @@ public:
    *
    * @warning The mutex() must be locked before calling this function!
    */
-  void clear_publics() noexcept
+  void clear_publics()
   {
     publics_.clear();
+    public_alternation_.reset();
+    publish();
+  }
+
+  /**
+   * @returns `true` if `path` matches some of publics().
+   *
+   * @details The literal and prefix publics are matched by plain string
+   * comparisons; the remaining publics added as pattern strings are matched
+   * in a single pass over an alternation regex precompiled upon add_public(),
+   * rather than one at a time.
+   *
+   * @warning The mutex() must be locked before calling this function!
+   */
+  bool is_public(const std::string& path) const
+  {
+    return is_public(publics_, public_alternation_, path);
   }
 
   // ---------------------------------------------------------------------------
@@ -520,6 +887,7 @@ public:
   Httper& set_auth_checker(Auth_checker checker)
   {
     auth_checker_ = std::move(checker);
+    publish();
     return *this;
   }
 
@@ -546,6 +914,8 @@ public:
   Httper& set_auth_prompter(Auth_prompter prompter)
   {
     auth_prompter_ = std::move(prompter);
+    auth_prompt_cache_.store({}, std::memory_order_release);
+    publish();
     return *this;
   }
 
@@ -577,6 +947,7 @@ public:
   Httper& set_before_tpler(Tpler tpler)
   {
     before_tpler_ = std::move(tpler);
+    publish();
     return *this;
   }
 
@@ -603,15 +974,15 @@ public:
   Httper& add_tpler(std::regex value, Tpler tpler)
   {
     tplers_.emplace_back(std::move(value), std::move(tpler));
+    publish();
     return *this;
   }
 
   /// @overload
   Httper& add_tpler(const std::string& value, Tpler tpler)
   {
-    using re = std::regex;
-    tplers_.emplace_back(re{value, re::ECMAScript|re::icase|re::optimize},
-      std::move(tpler));
+    tplers_.emplace_back(Route{value}, std::move(tpler));
+    publish();
     return *this;
   }
 
@@ -620,9 +991,10 @@ public:
    *
    * @warning The mutex() must be locked before calling this function!
    */
-  void clear_tplers() noexcept
+  void clear_tplers()
   {
     tplers_.clear();
+    publish();
   }
 
   // ---------------------------------------------------------------------------
@@ -648,15 +1020,15 @@ public:
   Httper& add_rpcer(std::regex value, Rpcer rpcer)
   {
     rpcers_.emplace_back(std::move(value), std::move(rpcer));
+    publish();
     return *this;
   }
 
   /// @overload
   Httper& add_rpcer(const std::string& value, Rpcer rpcer)
   {
-    using re = std::regex;
-    rpcers_.emplace_back(re{value, re::ECMAScript|re::icase|re::optimize},
-      std::move(rpcer));
+    rpcers_.emplace_back(Route{value}, std::move(rpcer));
+    publish();
     return *this;
   }
 
@@ -665,9 +1037,10 @@ public:
    *
    * @warning The mutex() must be locked before calling this function!
    */
-  void clear_rpcers() noexcept
+  void clear_rpcers()
   {
     rpcers_.clear();
+    publish();
   }
 
   // ---------------------------------------------------------------------------
@@ -693,6 +1066,7 @@ public:
   Httper& set_after_tpler(Tpler tpler)
   {
     after_tpler_ = std::move(tpler);
+    publish();
     return *this;
   }
 
@@ -719,6 +1093,7 @@ public:
   Httper& set_gener(Gener gener)
   {
     gener_ = std::move(gener);
+    publish();
     return *this;
   }
 
@@ -737,14 +1112,7 @@ public:
   Ret<tpl::Generic, Err>
   tpl(const std::filesystem::path& tplfile, const Request& req) const
   {
-    // Create the Lisp environment.
-    using lisp::make_expr;
-    lisp::Env env;
-    env.set("_lang", make_expr<lisp::Str_expr>(
-        std::string{to_string_view(req.language)}))
-      .set("_docroot", make_expr<lisp::Str_expr>(docroot_.generic_string()))
-      .set("_tplstack", make_expr<Tplstack_expr>());
-    return detail::tpl(tplfile, env);
+    return tpl(*snapshot(), tplfile, req);
   }
 
   // ---------------------------------------------------------------------------
@@ -776,26 +1144,58 @@ public:
         log::error("HTTP: request from {} aborted", remote_ip.to_string());
       });
 
-      // Check the method.
-      const auto method = str::to_uppercase(std::string{request.method()});
-      if (method != "GET" && method != "POST")
+      /*
+       * Check the method. The method name is packed into an integer and
+       * compared case-insensitively (methods are alphabetic, so setting the
+       * 0x20 bit per lane lowercases) - no std::string is allocated and no
+       * uppercase loop runs per request.
+       */
+      constexpr auto pack = [](const std::string_view str) noexcept
+      {
+        std::uint64_t result{};
+        for (std::size_t i{}; i < str.size() && i < 8; ++i)
+          result |= static_cast<std::uint64_t>(
+            static_cast<unsigned char>(str[i])) << 8*i;
+        return result;
+      };
+      constexpr std::uint64_t lowers{0x2020202020202020ull};
+      const auto method_name = request.method();
+      const auto method_word = pack(method_name) | lowers;
+      const bool is_get{method_name.size() == 3 &&
+        method_word == (pack("get") | lowers)};
+      const bool is_post{method_name.size() == 4 &&
+        method_word == (pack("post") | lowers)};
+      if (!is_get && !is_post)
         return send_error(io, http::Server_errc::method_not_allowed);
 
       // Check the request path.
       if (!is_valid_request_path(request.path()))
         return send_error(io, http::Server_errc::bad_request);
 
+      /*
+       * Pick up the current dispatch state. A single atomic load: the rest
+       * of the request handling involves no locks, and the mutators are free
+       * to publish a new snapshot concurrently.
+       */
+      const auto cfg = snapshot();
+
       // Get request info: normalized request path, filename etc.
       namespace fs = std::filesystem;
-      const auto reqpathfs = fs::path{str::to_lowercase(std::string{request.path()})}
-        .lexically_normal();
-      auto reqpath = reqpathfs.generic_string();
-      auto filepath = docroot_ / reqpathfs.relative_path();
-      auto filename = filepath.filename();
+      auto reqpath = [&request]
+      {
+        std::string result{request.path()};
+        str::lowercase_ascii(result);
+        return normalized_request_path(result);
+      }();
+      auto filepath = cfg->docroot;
+      filepath /= std::string_view{reqpath}.substr(1);
+      auto filename = fs::path{std::string_view{reqpath}.substr(
+        reqpath.find_last_of('/') + 1)};
       log::debug("Request path = {}", reqpath);
 
       // Maybe redirect from /path/to -> /path/to/.
-      if (!filename.empty() && !filename.has_extension() && !is_regular_file(filepath)) {
+      if (!filename.empty() && !filename.has_extension() &&
+        !stat_cache_.is_regular_file(filepath)) {
         reqpath += '/';
         io->send_status(http::Server_errc::moved_permanently);
         io->send_header("Location", reqpath);
@@ -804,12 +1204,15 @@ public:
       }
 
       // Prepare the request data.
-      const auto req = std::make_shared<Request>();
-      req->method = method;
+      const auto req = make_request();
+      req->method = is_get ? "GET" : "POST";
       req->path = std::move(reqpath);
       req->filepath = std::move(filepath);
       req->filename = std::move(filename);
-      req->cookie = http::Cookie{request.header("cookie")};
+      // An empty filename is served as index.html/index.thtml.
+      req->content_type_cached = !req->filename.empty() ?
+        content_type(req->filename) : std::string_view{"text/html"};
+      req->cookie_header = request.header("cookie");
       //
       if (is_behind_proxy_) {
         const auto xria = request.header("x-remote-ip-address");
@@ -819,47 +1222,61 @@ public:
       } else
         req->remote_ip_address = request.remote_ip_address();
       //
-      if (method == "GET") {
+      if (is_get) {
         req->query_string = url::Query_string{request.query_string()};
-      } else if (method == "POST") {
+      } else if (is_post) {
         req->body.reserve(64 * 1024);
         req->content_type = request.header("content-type");
       }
 
       // Get the language.
       std::optional<Language> lang;
-      if (const auto idx = req->cookie.entry_index("language"))
-        lang = to_language(req->cookie.entry(*idx).value());
+      if (const auto value = http::Cookie::find(req->cookie_header, "language"))
+        lang = to_language(*value);
       if (!lang && is_behind_proxy_)
         lang = to_language(request.header("x-default-language"));
       req->language = lang.value_or(default_language_);
 
-      // Wrap the rest of the handler into the continuator.
-      const auto continue_handle_request = [io, req, self = shared_from_this()]() -> void
+      /*
+       * Wrap the rest of the handler into the continuator. The continuator
+       * is one-shot, so the captured handles are moved (rather than copied)
+       * down the chain - into the inner handler and then into the thread
+       * pool task - sparing a pair of atomic reference count updates per
+       * handle per stage.
+       */
+      auto continue_handle_request =
+        [io, req, cfg, self = shared_from_this()]() mutable -> void
       {
-        const auto handle_request = [=]() -> void
+        auto handle_request = [io = std::move(io), req = std::move(req),
+          cfg = std::move(cfg), self]() -> void
         {
           try {
             // Check the authentication.
             {
-              const std::shared_lock lg{self->mutex_};
-
-              if (self->auth_checker_)
-                req->account_id = self->auth_checker_(*req);
+              if (cfg->auth_checker)
+                req->account_id = cfg->auth_checker(*req);
 
               if (!req->account_id) {
-                const bool is_auth_required = none_of(cbegin(self->publics_),
-                  cend(self->publics_), [req](const auto& re)
-                  {
-                    return regex_match(req->path, re);
-                  });
+                const bool is_auth_required = !is_public(cfg->publics,
+                  cfg->public_alternation, req->path);
                 if (is_auth_required) {
-                  io->loop_submit([io,
-                      prompt = self->auth_prompter_ ?
-                        self->auth_prompter_() : std::string{}]
+                  /*
+                   * The prompt is typically a static page, so its render is
+                   * cached until set_auth_prompter() is called again.
+                   */
+                  auto prompt =
+                    self->auth_prompt_cache_.load(std::memory_order_acquire);
+                  if (!prompt) {
+                    prompt = std::make_shared<const std::string>(
+                      cfg->auth_prompter ?
+                      cfg->auth_prompter() : std::string{});
+                    self->auth_prompt_cache_.store(prompt,
+                      std::memory_order_release);
+                  }
+                  io->loop_submit([io, prompt = std::move(prompt)]
                   {
-                    if (!prompt.empty())
-                      send_data(io, std::move(prompt), "text/html");
+                    if (!prompt->empty())
+                      send_data(io, *prompt, "text/html");
                     else
                       send_error(io, http::Server_errc::forbidden);
                   });
@@ -870,17 +1287,15 @@ public:
 
             // Try POST.
             if (req->method == "POST") {
-              const std::shared_lock lg{self->mutex_};
               DMITIGR_ASSERT(req->body.capacity());
               if (req->content_type == "application/json") {
-                const auto& rpcer = [self, req]() -> const Rpcer&
+                const auto& rpcer = [&cfg, req]() -> const Rpcer&
                 {
-                  for (const auto& p : self->rpcers_) {
-                    std::smatch sm;
-                    if (std::regex_match(req->path, sm, p.first)) {
-                      req->path_smatch = std::move(sm);
-                      return p.second;
-                    }
+                  std::cmatch sm;
+                  if (const auto i = match_route(cfg->rpcers,
+                      cfg->rpcer_literals, req->path, sm)) {
+                    req->path_smatch = std::move(sm);
+                    return cfg->rpcers[*i].second;
                   }
                   return invalid_rpcer_;
                 }();
@@ -897,7 +1312,7 @@ public:
                   }();
                   io->loop_submit([io, resbody]
                   {
-                    send_data(io, std::move(*resbody), "application/json");
+                    send_data(io, *resbody, "application/json", resbody);
                   });
                 } else
                   io->loop_submit([io]
@@ -913,12 +1328,13 @@ public:
             }
 
             // @returns `true` if `path` is a regular file.
-            const auto try_static_file = [io](auto&& path) -> bool
+            const auto try_static_file = [io, req, self](auto&& path) -> bool
             {
-              if (is_regular_file(path)) {
-                io->loop_submit([io, path = std::move(path)]
+              if (self->stat_cache_.is_regular_file(path)) {
+                io->loop_submit([io, path = std::move(path),
+                  type = req->content_type_cached]
                 {
-                  send_file(io, path, false);
+                  send_file(io, path, false, type);
                 });
                 return true;
               } else
@@ -934,36 +1350,34 @@ public:
              */
             const auto try_template = [&](auto&& path) -> bool
             {
-              const std::shared_lock lg{self->mutex_};
-
-              const auto& tpler = [self, req]() -> const Tpler&
+              const auto& tpler = [&cfg, req]() -> const Tpler&
               {
-                for (const auto& p : self->tplers_) {
-                  std::smatch sm;
-                  if (std::regex_match(req->path, sm, p.first)) {
-                    req->path_smatch = std::move(sm);
-                    return p.second;
-                  }
+                std::cmatch sm;
+                if (const auto i = match_route(cfg->tplers,
+                    cfg->tpler_literals, req->path, sm)) {
+                  req->path_smatch = std::move(sm);
+                  return cfg->tplers[*i].second;
                 }
                 return invalid_tpler_;
               }();
 
-              if (auto [err, tpl] = self->tpl(path, *req); !err) {
-                if (self->before_tpler_)
-                  self->before_tpler_(tpl, *req);
+              if (auto [err, tpl] = Httper::tpl(*cfg, path, *req); !err) {
+                if (cfg->before_tpler)
+                  cfg->before_tpler(tpl, *req);
                 if (tpler)
                   tpler(tpl, *req);
-                if (self->after_tpler_)
-                  self->after_tpler_(tpl, *req);
+                if (cfg->after_tpler)
+                  cfg->after_tpler(tpl, *req);
                 if (tpl.has_unbound_parameters()) {
                   const auto unbound_params = tpl.unbound_parameter_names();
                   throw Exception{"template for "+req->path+" has unbound parameters: "
                     +str::to_string(unbound_params, ", ")};
                 }
-                io->loop_submit([io, tpl = std::move(tpl), path = std::move(path)]
+                io->loop_submit([io, tpl = std::move(tpl),
+                  type = req->content_type_cached]
                 {
                   if (auto [err, out] = tpl.to_output(); !err)
-                    send_data(io, std::move(out), content_type(path));
+                    send_data(io, out, type);
                   else
                     log::error("HTTP: {}", message(err));
                 });
@@ -980,15 +1394,19 @@ public:
                 try_template(req->filepath / "index.thtml"))
                 return;
             } else {
-              if (const auto ext = req->filename.extension(); is_tpl_extension(ext)) {
+              // The extension is taken from the path without a path temporary.
+              const auto ext = extension_view(std::string_view{req->path}
+                .substr(req->path.find_last_of('/') + 1));
+              if (is_tpl_extension(ext)) {
                 if (try_template(req->filepath))
                   return;
-              } else if (const auto tplext = to_tpl_extension(ext); !tplext.empty()) {
+              } else if (const auto tplext = to_tpl_extension(ext);
+                !tplext.empty()) {
                 if (try_static_file(req->filepath))
                   return;
 
                 auto fpath = req->filepath;
-                fpath.replace_extension(tplext);
+                fpath.replace_extension(std::filesystem::path{tplext});
                 if (try_template(fpath))
                   return;
               } else {
@@ -998,13 +1416,10 @@ public:
             }
 
             // Finally, try gener or send error.
-            {
-              const std::shared_lock lg{self->mutex_};
-              if (self->gener_) {
-                self->gener_(io, *req);
-                return; // done: gener is called
-              } /* else ... */
-            }
+            if (cfg->gener) {
+              cfg->gener(io, *req);
+              return; // done: gener is called
+            } /* else ... */
             io->loop_submit([io]
             {
               send_error(io, http::Server_errc::not_found);
@@ -1029,23 +1444,22 @@ public:
           });
         };
 
-        {
-          const std::shared_lock lg{self->mutex_};
-          if (self->thread_pool_) {
-            self->thread_pool_->submit(handle_request);
-            return; // done: request handling is submitted to the thread pool
-          } else
-            log::error("HTTP: thread pool is not active, "
-              "handling the request on the IO thread!!!");
-        }
+        // The thread pool is set upon construction only: no lock is needed.
+        if (self->thread_pool_) {
+          self->thread_pool_->submit(std::move(handle_request));
+          return; // done: request handling is submitted to the thread pool
+        } else
+          log::error("HTTP: thread pool is not active, "
+            "handling the request on the IO thread!!!");
         handle_request();
       };
 
       // Submit the request handler to the thread pool if available.
-      if (method == "POST") {
+      if (is_post) {
         DMITIGR_ASSERT(req->body.capacity());
-        io->set_receive_handler([io, req, continue_handle_request]
-          (const std::string_view data, const bool is_last)
+        io->set_receive_handler([io, req,
+          continue_handle_request = std::move(continue_handle_request)]
+          (const std::string_view data, const bool is_last) mutable
         {
           if (req->body.size() + data.size() > req->body.capacity()) {
             log::error("HTTP: request body too large");
@@ -1095,25 +1509,233 @@ public:
   }
 
 private:
+  /**
+   * @brief An immutable snapshot of the dispatch state.
+   *
+   * @details Every mutator publishes a fresh copy of the state via publish(),
+   * and handle() picks it up with a single atomic load: the request handling
+   * involves no locks, while the requests already in flight keep the snapshot
+   * they started with alive until completion.
+   */
+  struct Snapshot final {
+    std::filesystem::path docroot;
+    lisp::Shared_expr docroot_expr;
+    std::vector<Route> publics;
+    std::optional<std::regex> public_alternation;
+    Auth_checker auth_checker;
+    Auth_prompter auth_prompter;
+    Tpler before_tpler;
+    std::vector<Regex_tpler_pair> tplers;
+    std::vector<Regex_rpcer_pair> rpcers;
+    Tpler after_tpler;
+    Gener gener;
+    /// The indexes of the literal routes of `tplers` keyed by their literals.
+    std::unordered_map<std::string, std::size_t> tpler_literals;
+    /// The indexes of the literal routes of `rpcers` keyed by their literals.
+    std::unordered_map<std::string, std::size_t> rpcer_literals;
+  };
+
   mutable std::shared_mutex mutex_;
   std::filesystem::path docroot_;
-  std::vector<std::regex> publics_;
+  lisp::Shared_expr docroot_expr_;
+  mutable Stat_cache stat_cache_;
+  std::vector<Route> publics_;
+  std::optional<std::regex> public_alternation_;
   std::shared_ptr<thread::Pool> thread_pool_;
   Language default_language_{Language::en};
   bool is_behind_proxy_{};
   Auth_checker auth_checker_;
   Auth_prompter auth_prompter_;
+  mutable std::atomic<std::shared_ptr<const std::string>> auth_prompt_cache_;
   Tpler before_tpler_;
   std::vector<Regex_tpler_pair> tplers_;
   std::vector<Regex_rpcer_pair> rpcers_;
   Tpler after_tpler_;
   Gener gener_;
+  mutable std::atomic<std::shared_ptr<const Snapshot>> snapshot_;
 
   inline const static Rpcer invalid_rpcer_;
   inline const static Tpler invalid_tpler_;
 
   // ---------------------------------------------------------------------------
 
+  /// Publishes the current dispatch state as a new immutable snapshot.
+  void publish()
+  {
+    auto snap = std::make_shared<Snapshot>();
+    snap->docroot = docroot_;
+    snap->docroot_expr = docroot_expr_;
+    snap->publics = publics_;
+    snap->public_alternation = public_alternation_;
+    snap->auth_checker = auth_checker_;
+    snap->auth_prompter = auth_prompter_;
+    snap->before_tpler = before_tpler_;
+    snap->tplers = tplers_;
+    snap->rpcers = rpcers_;
+    snap->after_tpler = after_tpler_;
+    snap->gener = gener_;
+    snap->tpler_literals = literal_index(snap->tplers);
+    snap->rpcer_literals = literal_index(snap->rpcers);
+    snapshot_.store(std::move(snap), std::memory_order_release);
+  }
+
+  /// @returns The indexes of the literal routes of `routes` keyed by literals.
+  template<class Pairs>
+  static std::unordered_map<std::string, std::size_t>
+  literal_index(const Pairs& routes)
+  {
+    std::unordered_map<std::string, std::size_t> result;
+    for (std::size_t i{}; i < routes.size(); ++i) {
+      const auto& route = routes[i].first;
+      if (route.is_literal())
+        result.try_emplace(*route.literal(), i); // the first route wins
+    }
+    return result;
+  }
+
+  /**
+   * @returns The index of the first route of `routes` which matches `path`
+   * (filling `sm` with the submatches), or `std::nullopt`.
+   *
+   * @details The literal routes are probed at once via the `literals` index
+   * built upon publish(), so only the non-literal routes are actually walked:
+   * a routing table of literal routes dispatches in a single hash lookup
+   * rather than in a match per route. The first-route-wins order is kept for
+   * the mixed tables - a non-literal route preceding the literal hit is still
+   * given the chance to match.
+   */
+  template<class Pairs>
+  static std::optional<std::size_t> match_route(const Pairs& routes,
+    const std::unordered_map<std::string, std::size_t>& literals,
+    const std::string& path, std::cmatch& sm)
+  {
+    const auto hit = literals.find(path);
+    const std::size_t limit{hit != cend(literals) ?
+      hit->second : routes.size()};
+    for (std::size_t i{}; i < limit; ++i) {
+      const auto& route = routes[i].first;
+      if (!route.is_literal() && route.matches(path, sm))
+        return i;
+    }
+    if (hit != cend(literals) && routes[hit->second].first.matches(path, sm))
+      return hit->second;
+    return std::nullopt;
+  }
+
+  /// @returns The current snapshot of the dispatch state. (Never null.)
+  std::shared_ptr<const Snapshot> snapshot() const noexcept
+  {
+    return snapshot_.load(std::memory_order_acquire);
+  }
+
+  /// @returns `true` if `path` matches some of `publics`.
+  static bool is_public(const std::vector<Route>& publics,
+    const std::optional<std::regex>& alternation, const std::string& path)
+  {
+    return any_of(cbegin(publics), cend(publics),
+      [&path](const auto& route)
+      {
+        // The pattern-built genuine regexes are covered by the alternation.
+        return (route.is_literal() || route.is_prefix() || !route.pattern()) &&
+          route.matches(path);
+      }) ||
+      (alternation && std::regex_match(path, *alternation));
+  }
+
+  /// @returns The template expanded in the environment of `snap`.
+  static Ret<tpl::Generic, Err>
+  tpl(const Snapshot& snap, const std::filesystem::path& tplfile,
+    const Request& req)
+  {
+    /*
+     * Create the Lisp environment. "_lang" and "_docroot" are invariant per
+     * language/snapshot, so their expressions are created once and shared:
+     * per call only "_tplstack" is actually constructed.
+     */
+    using lisp::make_expr;
+    lisp::Env env;
+    env.set("_lang", lang_expr(req.language))
+      .set("_docroot", snap.docroot_expr)
+      .set("_tplstack", make_expr<Tplstack_expr>());
+    return detail::tpl(tplfile, env);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @returns The shared "_lang" expression for `lang`, created on first use.
+  static const lisp::Shared_expr& lang_expr(const Language lang)
+  {
+    static const lisp::Shared_expr en{
+      lisp::make_expr<lisp::Str_expr>(std::string{"en"})};
+    static const lisp::Shared_expr ru{
+      lisp::make_expr<lisp::Str_expr>(std::string{"ru"})};
+    switch (lang) {
+    case Language::en: return en;
+    case Language::ru: return ru;
+    }
+    throw Exception{"invalid native representation of Language"};
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// Recompiles the alternation of the pattern-built genuine regex publics.
+  void rebuild_public_alternation()
+  {
+    std::string alternation;
+    for (const auto& route : publics_) {
+      if (!route.is_literal() && !route.is_prefix() && route.pattern())
+        alternation.append("(?:").append(*route.pattern()).append(")|");
+    }
+    if (!alternation.empty()) {
+      alternation.pop_back();
+      public_alternation_.emplace(alternation,
+        std::regex::ECMAScript|std::regex::icase|std::regex::optimize|
+        std::regex::nosubs);
+    } else
+      public_alternation_.reset();
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @returns The pool of Request instances of the calling thread.
+  static std::vector<std::unique_ptr<Request>>& request_pool()
+  {
+    thread_local std::vector<std::unique_ptr<Request>> result;
+    return result;
+  }
+
+  /**
+   * @returns A Request instance taken from the pool of the calling thread,
+   * or a newly allocated one if the pool is empty.
+   *
+   * @details Upon release the instance is cleared and returned to the pool
+   * of the releasing thread rather than destroyed, so the internal buffers
+   * (notably the 64 KiB body buffer reserved for every POST) are reused
+   * instead of being reallocated per request.
+   */
+  static std::shared_ptr<Request> make_request()
+  {
+    auto& pool = request_pool();
+    std::unique_ptr<Request> result;
+    if (!pool.empty()) {
+      result = std::move(pool.back());
+      pool.pop_back();
+    } else
+      result = std::make_unique<Request>();
+    return {result.release(), [](Request* const request)
+    {
+      constexpr std::size_t max_pool_size{64};
+      auto& pool = request_pool();
+      if (pool.size() < max_pool_size) {
+        request->clear();
+        pool.emplace_back(request);
+      } else
+        delete request;
+    }};
+  }
+
+  // ---------------------------------------------------------------------------
+
   /// The constructor.
   explicit Httper(std::shared_ptr<thread::Pool> thread_pool,
     const Config& cfg)
@@ -1123,6 +1745,8 @@ private:
   {
     if (to_string_view(default_language_).empty())
       throw Exception{"invalid default language"};
+
+    publish();
   }
 };
 
@@ -19,6 +19,7 @@
 
 #include "../base/stream.hpp"
 #include "../lisp/lisp.hpp"
+#include "../os/mmap.hpp"
 #include "../tpl/generic.hpp"
 #include "errc.hpp"
 #include "util.hpp"
@@ -26,7 +27,11 @@
 #include <algorithm>
 #include <cstdint>
 #include <filesystem>
+#include <map>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace dmitigr::web {
@@ -37,6 +42,8 @@ constexpr int type_tpl{1};
 constexpr int type_tplstack{2};
 /// Httper type identifier.
 constexpr int type_httper{3};
+/// Filesystem path type identifier.
+constexpr int type_path{4};
 
 inline bool is_tpl(const lisp::Shared_expr& e) noexcept
 {
@@ -53,6 +60,11 @@ inline bool is_httper(const lisp::Shared_expr& e) noexcept
   return e->type() == type_httper;
 }
 
+inline bool is_path(const lisp::Shared_expr& e) noexcept
+{
+  return e->type() == type_path;
+}
+
 class Tpl_expr : public lisp::Expr {
 public:
   explicit Tpl_expr(tpl::Generic tpl)
@@ -103,7 +115,10 @@ public:
 
   explicit Tplstack_expr(std::vector<std::filesystem::path> stack)
     : stack_{std::move(stack)}
-  {}
+  {
+    for (const auto& path : stack_)
+      set_.insert(path.generic_string());
+  }
 
   int type() const noexcept override
   {
@@ -126,7 +141,7 @@ public:
 
   Ret<int> cmp(const lisp::Shared_expr& rhs) const noexcept override
   {
-    if (is_tpl(rhs)) {
+    if (is_tplstack(rhs)) {
       const auto rhs_tplstack = std::static_pointer_cast<Tplstack_expr>(rhs);
       return stack() < rhs_tplstack->stack() ? -1 :
         stack() == rhs_tplstack->stack() ? 0 : 1;
@@ -144,8 +159,91 @@ public:
     return stack_;
   }
 
+  /// Pushes `path` onto the stack.
+  void push(const std::filesystem::path& path)
+  {
+    stack_.push_back(path);
+    set_.insert(path.generic_string());
+  }
+
+  /// Pops the last pushed path off the stack.
+  void pop()
+  {
+    set_.erase(stack_.back().generic_string());
+    stack_.pop_back();
+  }
+
+  /**
+   * @returns `true` if `path` was pushed and not yet popped.
+   *
+   * @remarks A hashed lookup: the stack depth doesn't matter.
+   */
+  bool contains(const std::filesystem::path& path) const
+  {
+    return static_cast<bool>(set_.count(path.generic_string()));
+  }
+
 private:
   std::vector<std::filesystem::path> stack_;
+  std::unordered_set<std::string> set_;
+};
+
+/**
+ * @brief A filesystem path expression.
+ *
+ * @details Behaves as a string expression in the output (str(), to_output()),
+ * but carries the path parsed once upon construction, so the consumers like
+ * detail::tplfile() need no string-to-path conversion per call.
+ */
+class Path_expr final : public lisp::Expr {
+public:
+  explicit Path_expr(std::filesystem::path path)
+    : path_{std::move(path)}
+    , str_{path_.generic_string()}
+  {}
+
+  int type() const noexcept override
+  {
+    return type_path;
+  }
+
+  lisp::Shared_expr clone() const override
+  {
+    return std::make_shared<Path_expr>(*this);
+  }
+
+  const std::string& str() const noexcept override
+  {
+    return str_;
+  }
+
+  std::string to_string() const override
+  {
+    return std::string{"'"}.append(str_).append("'");
+  }
+
+  Ret<std::string, Err> to_output() const override
+  {
+    return std::string{str_};
+  }
+
+  Ret<int> cmp(const lisp::Shared_expr& rhs) const noexcept override
+  {
+    if (is_path(rhs) || is_str(rhs))
+      return str() < rhs->str() ? -1 : str() == rhs->str() ? 0 : 1;
+    else
+      return lisp::Errc::expr_not_string;
+  }
+
+  /// @returns The path.
+  const std::filesystem::path& path() const noexcept
+  {
+    return path_;
+  }
+
+private:
+  std::filesystem::path path_;
+  std::string str_;
 };
 
 // =============================================================================
@@ -160,6 +258,18 @@ inline const auto& str(const lisp::Env& env, const std::string_view name)
   return ret.res->str();
 }
 
+/// @returns The path of the variable `name` of `env`.
+inline std::filesystem::path path(const lisp::Env& env,
+  const std::string_view name)
+{
+  const auto ret = env.expr(name);
+  DMITIGR_ASSERT(ret);
+  if (is_path(ret.res))
+    return std::static_pointer_cast<Path_expr>(ret.res)->path();
+  DMITIGR_ASSERT(is_str(ret.res));
+  return std::filesystem::path{ret.res->str()};
+}
+
 inline auto rebased(std::filesystem::path path,
   const std::filesystem::path& docroot)
 {
@@ -180,20 +290,161 @@ inline auto stack_graph(std::vector<std::filesystem::path>& stack,
   return graph;
 }
 
-inline Err tpl_check_cycle(std::vector<std::filesystem::path>& stack,
+inline Err tpl_check_cycle(Tplstack_expr& tplstack,
   const std::filesystem::path& tplfile,
   const std::filesystem::path& docroot)
 {
-  const auto beg = cbegin(stack);
-  const auto end = cend(stack);
-  if (find(beg, end, tplfile) != end) {
-    auto graph = stack_graph(stack, docroot);
+  if (tplstack.contains(tplfile)) {
+    auto graph = stack_graph(tplstack.stack(), docroot);
     graph.append(" -> ").append(tplfile.string());
     return Err{Errc::tpl_cycle, "template reference cyclicity: " + graph};
   }
   return Err{};
 }
 
+/**
+ * @brief A bounded cache of parsed template files.
+ *
+ * @details Parsing a template is deterministic in the file content, so the
+ * freshly parsed form is cached keyed by the file path and validated by the
+ * file size and modification time: a hot template is copied out of the cache
+ * instead of being re-read and re-tokenized on every request. The parsed
+ * bodies are also interned by the content hash: the scaffolded template
+ * files often share identical bodies, and such files share one parsed body
+ * rather than each being parsed and stored again. (The evaluation of the
+ * Lisp expressions depends on the environment and is never cached.)
+ */
+class Tpl_cache final {
+public:
+  /**
+   * @brief A map of parameter names to parsed Lisp expressions.
+   *
+   * @details The parameter names are fixed at template parse time, so their
+   * Lisp parses are done once per template load rather than once per render.
+   * A null expression records a name which is not a Lisp expression.
+   */
+  using Parses = std::unordered_map<std::string, lisp::Shared_expr>;
+
+  /**
+   * @returns The parsed `tplfile`, from the cache whenever it is unchanged.
+   *
+   * @param parses Assigned the parameter parses of the returned template.
+   */
+  Ret<tpl::Generic, Err> parsed(const std::filesystem::path& tplfile,
+    std::shared_ptr<const Parses>& parses)
+  {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    const auto mtime = fs::last_write_time(tplfile, ec);
+    const auto size = !ec ? fs::file_size(tplfile, ec) : 0;
+    if (!ec) {
+      const std::shared_lock lg{mutex_};
+      if (const auto i = map_.find(tplfile.native());
+        i != cend(map_) && i->second.mtime == mtime && i->second.size == size) {
+        parses = i->second.body->parses;
+        return tpl::Generic{i->second.body->parsed};
+      }
+    }
+
+    const auto input = read_to_string(tplfile);
+
+    // Take an already parsed identical body from the intern pool, if any.
+    const auto hash = content_hash(input);
+    std::shared_ptr<const Body> body;
+    {
+      const std::shared_lock lg{mutex_};
+      if (const auto i = interned_.find(hash); i != cend(interned_))
+        body = i->second.lock();
+    }
+
+    if (!body) {
+      auto [err, result] = tpl::Generic::make(input, "<{{", "}}>");
+      if (err)
+        return std::move(err);
+
+      auto prs = std::make_shared<Parses>();
+      for (std::size_t p{}, pcount{result.parameter_count()}; p < pcount; ++p) {
+        const auto& pname = result.parameter(p)->name();
+        const auto [perr, pres] = lisp::parse(pname);
+        prs->try_emplace(pname, !perr ? pres.expr : lisp::Shared_expr{});
+      }
+      body = std::make_shared<const Body>(
+        Body{std::move(result), std::move(prs)});
+    }
+
+    parses = body->parses;
+    auto result = tpl::Generic{body->parsed};
+
+    if (!ec) {
+      const std::lock_guard lg{mutex_};
+      if (map_.size() >= max_size) {
+        map_.clear();
+        interned_.clear();
+      }
+      interned_.insert_or_assign(hash, body);
+      map_.insert_or_assign(tplfile.native(),
+        Entry{mtime, size, std::move(body)});
+    }
+    return std::move(result);
+  }
+
+  /// Clears the cache.
+  void clear()
+  {
+    const std::lock_guard lg{mutex_};
+    map_.clear();
+    interned_.clear();
+  }
+
+private:
+  /// A parsed template body, shared by every file with identical content.
+  struct Body final {
+    tpl::Generic parsed;
+    std::shared_ptr<const Parses> parses;
+  };
+
+  struct Entry final {
+    std::filesystem::file_time_type mtime;
+    std::uintmax_t size{};
+    std::shared_ptr<const Body> body;
+  };
+
+  constexpr static std::size_t max_size{1024};
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::filesystem::path::string_type, Entry> map_;
+  /// The intern pool of the parsed bodies keyed by the content hash.
+  std::map<std::pair<std::uint64_t, std::uint64_t>,
+    std::weak_ptr<const Body>> interned_;
+
+  /**
+   * @returns The pair of FNV-1a hashes of `input`.
+   *
+   * @remarks A pair (with the distinct offset bases) rather than a single
+   * 64-bit hash: a collision would silently serve the wrong template, so
+   * it has to be out of practical reach.
+   */
+  static std::pair<std::uint64_t, std::uint64_t>
+  content_hash(const std::string_view input) noexcept
+  {
+    constexpr std::uint64_t prime{0x100000001b3};
+    std::uint64_t h1{0xcbf29ce484222325};
+    std::uint64_t h2{0x84222325cbf29ce4};
+    for (const auto ch : input) {
+      const auto byte = static_cast<unsigned char>(ch);
+      h1 = (h1 ^ byte) * prime;
+      h2 = (h2 ^ byte) * prime;
+    }
+    return {h1, h2};
+  }
+};
+
+/// @returns The cache of parsed template files.
+inline Tpl_cache& tpl_cache()
+{
+  static Tpl_cache result;
+  return result;
+}
+
 inline Ret<tpl::Generic, Err>
 tpl(const std::filesystem::path& tplfile, lisp::Env& env)
 {
@@ -203,41 +454,59 @@ tpl(const std::filesystem::path& tplfile, lisp::Env& env)
   const auto tplstack_ret = env.expr("_tplstack");
   DMITIGR_ASSERT(tplstack_ret);
   DMITIGR_ASSERT(is_tplstack(tplstack_ret.res));
-  auto& stack =
-    std::static_pointer_cast<Tplstack_expr>(tplstack_ret.res)->stack();
-  const fs::path docroot{str(env, "_docroot")};
-
-  // Shadow and modify the environment.
-  auto shadowed_env = env;
-  shadowed_env.set("_tplorig",
-    lisp::make_expr<lisp::Str_expr>(tplfile.generic_string()));
+  auto& tplstack = *std::static_pointer_cast<Tplstack_expr>(tplstack_ret.res);
+  const auto docroot = path(env, "_docroot");
+
+  /*
+   * Shadow "_tplorig" for the duration of this frame. The environment is
+   * threaded through the recursion by reference: one binding save/restore
+   * per frame instead of a copy of the whole environment.
+   */
+  struct Tplorig_shadow final {
+    ~Tplorig_shadow()
+    {
+      if (prev_)
+        env_.set("_tplorig", prev_);
+      else
+        env_.unset("_tplorig");
+    }
+    Tplorig_shadow(lisp::Env& env, const fs::path& tplfile)
+      : env_{env}
+      , prev_{env.expr("_tplorig").res}
+    {
+      env_.set("_tplorig", lisp::make_expr<Path_expr>(tplfile));
+    }
+    lisp::Env& env_;
+    lisp::Shared_expr prev_;
+  };
+  const Tplorig_shadow shadow{env, tplfile};
 
   // Check the possible template reference cyclicity.
-  if (auto e = detail::tpl_check_cycle(stack, tplfile, docroot))
+  if (auto e = detail::tpl_check_cycle(tplstack, tplfile, docroot))
     return e;
 
   // Cope the stack.
   struct Stack_tracker final {
     ~Stack_tracker()
     {
-      stack_.pop_back();
+      tplstack_.pop();
     }
-    Stack_tracker(decltype(stack)& stack, const fs::path& tplfile)
-      : stack_{stack}
+    Stack_tracker(Tplstack_expr& tplstack, const fs::path& tplfile)
+      : tplstack_{tplstack}
     {
-      stack_.push_back(tplfile);
+      tplstack_.push(tplfile);
     }
-    decltype(stack)& stack_;
+    Tplstack_expr& tplstack_;
   };
-  const Stack_tracker guard{stack, tplfile};
+  const Stack_tracker guard{tplstack, tplfile};
 
   // Check the template file existence.
   if (!is_regular_file(tplfile))
-    return Err{Errc::file_not_found, stack_graph(stack, docroot)};
+    return Err{Errc::file_not_found, stack_graph(tplstack.stack(), docroot)};
 
-  // Read the template into memory.
-  const auto input = read_to_string(tplfile);
-  auto [err, result] = tpl::Generic::make(input, "<{{", "}}>");
+  // Get the parsed template (bypassing the read/parse whenever it is cached).
+  std::shared_ptr<const Tpl_cache::Parses> parses;
+  auto [err, result] = tpl_cache().parsed(tplfile, parses);
   if (err)
     return std::move(err);
 
@@ -246,16 +515,23 @@ tpl(const std::filesystem::path& tplfile, lisp::Env& env)
     // Get the parameter name.
     const std::string& pname = result.parameter(p)->name();
 
-    // Try to parse Lisp expression.
-    namespace lisp = dmitigr::lisp;
-    const auto [parse_err, parse_res] = lisp::parse(pname);
-    if (parse_err) {
+    /*
+     * Get the Lisp expression, parsed once at template load. The parameters
+     * spliced in by replace() below originate from other templates, so their
+     * names are parsed in place.
+     */
+    lisp::Shared_expr pexpr;
+    if (const auto i = parses->find(pname); i != cend(*parses))
+      pexpr = i->second;
+    else if (const auto [perr, pres] = lisp::parse(pname); !perr)
+      pexpr = pres.expr;
+    if (!pexpr) {
       ++p;
       continue;
     }
 
     // Evaluate the Lisp expression.
-    auto [eval_err, eval_res] = parse_res.expr->eval(shadowed_env);
+    auto [eval_err, eval_res] = pexpr->eval(env);
     if (eval_err)
       return std::move(eval_err);
 
@@ -277,20 +553,28 @@ tpl(const std::filesystem::path& tplfile, lisp::Env& env)
 inline std::filesystem::path tplfile(const std::filesystem::path& tplfile,
   const lisp::Env& env)
 {
-  namespace fs = std::filesystem;
-  // tplorig - tplfile from what `web-tpl`, `web-esc`, etc functions was called.
-  const fs::path tplorig{detail::str(env, "_tplorig")};
-  fs::path root{detail::str(env, "_docroot")};
-  if (!tplfile.is_absolute())
-    root = tplorig.parent_path();
+  /*
+   * tplorig - tplfile from what `web-tpl`, `web-esc`, etc functions was
+   * called. The docroot is only consulted for an absolute reference.
+   */
+  auto root = tplfile.is_absolute() ? detail::path(env, "_docroot") :
+    detail::path(env, "_tplorig").parent_path();
   return root / tplfile.relative_path();
 }
 
-inline auto read_to_str(const std::filesystem::path& path)
+/**
+ * @returns The file at `path` mapped into the address space of the process.
+ *
+ * @details The content comes straight from the page cache with no
+ * read-buffer copy, and on a repeated hit the mapping is instant.
+ */
+inline auto map_file(const std::filesystem::path& path) noexcept
 {
-  static const auto read = static_cast<
-    std::string(*)(const std::filesystem::path&)>(&read_to_string);
-  return call_nothrow(read, path);
+  static const auto map = [](const std::filesystem::path& path)
+  {
+    return os::Mem_mapped_file{path};
+  };
+  return call_nothrow(map, path);
 }
 
 } // namespace detail
@@ -308,13 +592,14 @@ inline lisp::Ret_expr fun_web_raw(const lisp::Tup_expr& fun, lisp::Env& env)
     if (is_str(r.res)) {
       namespace fs = std::filesystem;
       const auto tplfile = detail::tplfile(r.res->str(), env);
-      auto [err, res] = detail::read_to_str(tplfile);
+      const auto [err, map] = detail::map_file(tplfile);
       if (err)
         return Err{std::move(err), fun.fun_name()};
-      else if (std::any_of(cbegin(res), cend(res), str::is_zero))
+      const std::string_view res{map.data(), map.size()};
+      if (std::any_of(cbegin(res), cend(res), str::is_zero))
         return Err{Errc::txt_invalid, fun.fun_name()};
       else
-        return lisp::make_expr<lisp::Str_expr>(std::move(res));
+        return lisp::make_expr<lisp::Str_expr>(std::string{res});
     } else
       return Err{lisp::Errc::fun_usage, fun.fun_name()};
   } else
@@ -334,10 +619,11 @@ inline lisp::Ret_expr fun_web_esc(const lisp::Tup_expr& fun, lisp::Env& env)
     if (is_str(r.res)) {
       namespace fs = std::filesystem;
       const auto tplfile = detail::tplfile(r.res->str(), env);
-      auto [err, res] = detail::read_to_str(tplfile);
+      const auto [err, map] = detail::map_file(tplfile);
       if (err)
         return Err{std::move(err), fun.fun_name()};
-      else if (std::any_of(cbegin(res), cend(res), str::is_zero))
+      const std::string_view res{map.data(), map.size()};
+      if (std::any_of(cbegin(res), cend(res), str::is_zero))
         return Err{Errc::txt_invalid, fun.fun_name()};
       else
         return lisp::make_expr<lisp::Str_expr>(esc(res));
@@ -372,6 +658,12 @@ inline lisp::Ret_expr fun_web_tpl(const lisp::Tup_expr& fun, lisp::Env& env)
 
 // =============================================================================
 
+/// Clears the cache of parsed template files.
+inline void clear_tpl_cache()
+{
+  detail::tpl_cache().clear();
+}
+
 inline void init_lisp()
 {
   lisp::lib::init();
@@ -17,22 +17,82 @@
 #ifndef DMITIGR_WEB_UTIL_HPP
 #define DMITIGR_WEB_UTIL_HPP
 
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <string_view>
 
 namespace dmitigr::web {
 
-/// @returns An escaped HTML.
+/**
+ * @returns An escaped HTML.
+ *
+ * @details The input is scanned a word at a time: eight bytes are tested
+ * for the presence of a character to escape with the zero-byte trick, and
+ * on typical HTML (where most windows contain nothing to escape) whole
+ * runs are appended at once rather than byte by byte. The windows which do
+ * contain such a character are copied through a 256-entry replacement
+ * table - one branchless append per byte instead of two compares. The
+ * result is reserved up front, so a typical input is copied with a single
+ * growth.
+ */
 inline std::string esc(const std::string_view input)
 {
+  // @returns Nonzero if some byte of `word` equals `ch`.
+  constexpr auto has_byte = [](const std::uint64_t word, const char ch) noexcept
+  {
+    constexpr std::uint64_t ones{0x0101010101010101ull};
+    const auto v = word ^ (ones * static_cast<unsigned char>(ch));
+    return (v - ones) & ~v & (ones * 0x80u);
+  };
+
+  // The identity bytes the passthrough entries of `table` point into.
+  static constexpr auto bytes = []
+  {
+    std::array<char, 256> result{};
+    for (int i{}; i < 256; ++i)
+      result[static_cast<std::size_t>(i)] = static_cast<char>(i);
+    return result;
+  }();
+  // The replacement table: `<` and `>` map to entities, the rest to itself.
+  struct Esc final {
+    const char* str;
+    unsigned char size;
+  };
+  static constexpr auto table = []
+  {
+    std::array<Esc, 256> result{};
+    for (std::size_t i{}; i < 256; ++i)
+      result[i] = {&bytes[i], 1};
+    result[static_cast<unsigned char>('<')] = {"&lt;", 4};
+    result[static_cast<unsigned char>('>')] = {"&gt;", 4};
+    return result;
+  }();
+
   std::string result;
-  for (const auto ch : input) {
-    if (ch == '<')
-      result += "&lt;";
-    else if (ch == '>')
-      result += "&gt;";
-    else
-      result += ch;
+  result.reserve(input.size() + input.size()/8);
+  const char* ptr{input.data()};
+  const char* const end{ptr + input.size()};
+  const char* run{ptr};
+  while (end - ptr >= 8) {
+    std::uint64_t word;
+    std::memcpy(&word, ptr, 8);
+    if (!(has_byte(word, '<') | has_byte(word, '>'))) {
+      ptr += 8;
+      continue;
+    }
+    result.append(run, ptr - run);
+    for (const char* const stop = ptr + 8; ptr < stop; ++ptr) {
+      const auto& e = table[static_cast<unsigned char>(*ptr)];
+      result.append(e.str, e.size);
+    }
+    run = ptr;
+  }
+  result.append(run, ptr - run);
+  for (; ptr < end; ++ptr) {
+    const auto& e = table[static_cast<unsigned char>(*ptr)];
+    result.append(e.str, e.size);
   }
   return result;
 }
@@ -22,6 +22,8 @@
 #include "../ws/ws.hpp"
 #include "exceptions.hpp"
 
+#include <vector>
+
 namespace dmitigr::web {
 
 class Ws_jrpc_connection : public dmitigr::ws::Connection {
@@ -47,7 +49,13 @@ protected:
 
       std::uint_fast64_t id{};
       try {
-        const auto req = jrpc::Request::from_json(payload);
+        /*
+         * Parse in place: the payload is copied once into the buffer and
+         * the string values are decoded right in it, rather than each
+         * being copied into the DOM-owned storage.
+         */
+        const auto req = jrpc::Request::from_json_insitu(
+          std::vector<char>{payload.cbegin(), payload.cend()});
         if (!req.id()) {
           // Ignore notification.
           log::warning("wsjrpc::handle_message: notification ignored");
@@ -20,6 +20,7 @@
 #include "../base/assert.hpp"
 #include "../base/noncopymove.hpp"
 #include "exceptions.hpp"
+#include "strconv.hpp"
 #include "windows.hpp"
 
 #include <algorithm>
@@ -48,7 +49,7 @@ public:
   {
     DWORD name_size{};
     DWORD domain_size{};
-    const LPCWSTR system{!system_name.empty() ? system_name.c_str() : nullptr};
+    const LPCWSTR system{c_str_or_null(system_name)};
 
     LookupAccountSidW(system, sid,
       nullptr, &name_size, nullptr, &domain_size, nullptr);
@@ -71,7 +72,7 @@ public:
   Account(std::wstring name, const std::wstring& system_name)
     : name_{std::move(name)}
   {
-    const LPCWSTR system{!system_name.empty() ? system_name.c_str() : nullptr};
+    const LPCWSTR system{c_str_or_null(system_name)};
     DWORD sid_buf_size{};
     DWORD domain_size{};
     LookupAccountNameW(system, name_.c_str(), nullptr, &sid_buf_size,
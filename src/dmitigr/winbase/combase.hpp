@@ -23,10 +23,14 @@
 #include "strconv.hpp"
 
 #include <algorithm>
+#include <cstring>
+#include <initializer_list>
 #include <new>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -119,15 +123,40 @@ inline auto to_com_string(REFCLSID id)
 // Registry
 // -----------------------------------------------------------------------------
 
+namespace detail {
+
+/**
+ * @returns `SOFTWARE\Classes\CLSID\{id}` with `suffix` appended.
+ *
+ * @details The CLSID string is of the fixed 38-character form, so the whole
+ * subkey is formatted on the stack: no CoTaskMemAlloc/CoTaskMemFree round
+ * trip of StringFromCLSID and no append-driven reallocation - the returned
+ * string is allocated once at the exact size.
+ */
+inline std::wstring server_registry_path(REFCLSID id,
+  const std::wstring_view suffix)
+{
+  constexpr std::wstring_view prefix{LR"(SOFTWARE\Classes\CLSID\)"};
+  wchar_t buf[prefix.size() + 39];
+  std::copy(prefix.cbegin(), prefix.cend(), buf);
+  const int size{StringFromGUID2(id, buf + prefix.size(), 39)};
+  if (!size)
+    throw std::runtime_error{"cannot convert CLSID to string"};
+  std::wstring result;
+  result.reserve(prefix.size() + size - 1 + suffix.size());
+  return result.append(buf, prefix.size() + size - 1).append(suffix);
+}
+
+} // namespace detail
+
 inline std::wstring server_registry_root(REFCLSID id)
 {
-  return std::wstring{LR"(SOFTWARE\Classes\CLSID\)"}
-    .append(to_com_string(id).value());
+  return detail::server_registry_path(id, {});
 }
 
 inline std::wstring server_registry_localserver32(REFCLSID id)
 {
-  return server_registry_root(id).append(LR"(\LocalServer32)");
+  return detail::server_registry_path(id, LR"(\LocalServer32)");
 }
 
 // -----------------------------------------------------------------------------
@@ -161,20 +190,24 @@ public:
 
   ~Basic_variant()
   {
-    if constexpr (IsOwns)
-      VariantClear(&data_);
+    if constexpr (IsOwns) {
+      // VariantClear() on a trivial payload only resets vt to VT_EMPTY --
+      // not worth an OleAut32 dispatch from every destructor.
+      if (!is_trivial(data_.vt))
+        VariantClear(&data_);
+    }
   }
 
-  Basic_variant()
-  {
-    VariantInit(&data_);
-  }
+  /**
+   * @remarks The default member initializer of data_ zeroes the VARIANT,
+   * which is what VariantInit() does, so the constructors below don't call
+   * it just to overwrite the result.
+   */
+  Basic_variant() = default;
 
   Basic_variant(const VARIANT dat)
-  {
-    VariantInit(&data_);
-    data_ = dat;
-  }
+    : data_{dat}
+  {}
 
   template<bool IsRhsConst, bool IsRhsOwns,
     typename = std::enable_if_t<IsOwns && !IsRhsOwns>>
@@ -188,7 +221,6 @@ public:
   Basic_variant(const Basic_variant<IsRhsConst, IsRhsOwns>& rhs)
   {
     static_assert(IsOwns || IsConst || !IsRhsConst);
-    VariantInit(&data_);
     if constexpr (IsOwns)
       copy_from(rhs);
     else
@@ -207,10 +239,9 @@ public:
   template<bool IsRhsConst, bool IsRhsOwns,
     typename = std::enable_if_t<IsOwns == IsRhsOwns>>
   Basic_variant(Basic_variant<IsRhsConst, IsRhsOwns>&& rhs) noexcept
+    : data_{rhs.data_}
   {
     static_assert(IsConst || !IsRhsConst);
-    VariantInit(&data_);
-    data_ = rhs.data_;
     VariantInit(&rhs.data_);
   }
 
@@ -237,7 +268,10 @@ public:
   Variant to_variant(const VARENUM vt, const USHORT flags = {}) const
   {
     Variant result;
-    if (VariantChangeType(&result.data_, &data_, flags, vt) != S_OK)
+    // VariantChangeType() doesn't modify the source; the const_cast is
+    // forced by its pre-const-correctness signature.
+    if (VariantChangeType(&result.data_, const_cast<VARIANT*>(&data_),
+        flags, vt) != S_OK)
       throw std::runtime_error{"cannot convert VARIANT to VARIANT"};
     return result;
   }
@@ -276,6 +310,18 @@ public:
     return com::to_wstring(data_.bstrVal);
   }
 
+  /**
+   * @returns The value as a read-only UTF-16 view: no copy.
+   *
+   * @remarks The result refers to the BSTR storage reachable through this
+   * instance and is only valid while that storage lives.
+   */
+  std::wstring_view as_wstring_view() const
+  {
+    check(VT_BSTR, "UTF-16 string");
+    return com::to_wstring_view(data_.bstrVal);
+  }
+
   std::int8_t as_int8() const
   {
     check(VT_I1, "int8");
@@ -302,20 +348,26 @@ public:
 
   std::int32_t as_int32() const
   {
-    if (is(VT_I4))
+    switch (data_.vt) {
+    case VT_I4:
       return data_.lVal;
-    else if (is(VT_INT))
+    case VT_INT:
       return data_.intVal;
-    throw_conversion_error("int32");
+    default:
+      throw_conversion_error("int32");
+    }
   }
 
   std::uint32_t as_uint32() const
   {
-    if (is(VT_UI4))
+    switch (data_.vt) {
+    case VT_UI4:
       return data_.ulVal;
-    else if (is(VT_UINT))
+    case VT_UINT:
       return data_.uintVal;
-    throw_conversion_error("uint32");
+    default:
+      throw_conversion_error("uint32");
+    }
   }
 
   std::int64_t as_int64() const
@@ -383,13 +435,38 @@ public:
   }
 
 private:
-  mutable VARIANT data_{};
+  VARIANT data_{};
 
   template<bool, bool> friend class Basic_variant;
 
+  /// @returns `true` if `vt` denotes a payload a plain VARIANT copy copies.
+  static bool is_trivial(const VARTYPE vt) noexcept
+  {
+    if (vt & ~VT_TYPEMASK) // VT_ARRAY, VT_BYREF, VT_VECTOR
+      return false;
+    switch (vt) {
+    case VT_EMPTY: case VT_NULL:
+    case VT_I2: case VT_I4: case VT_R4: case VT_R8:
+    case VT_CY: case VT_DATE: case VT_ERROR: case VT_BOOL:
+    case VT_DECIMAL:
+    case VT_I1: case VT_UI1: case VT_UI2: case VT_UI4:
+    case VT_I8: case VT_UI8: case VT_INT: case VT_UINT:
+      return true;
+    default: // VT_BSTR, VT_DISPATCH, VT_UNKNOWN, VT_RECORD etc.
+      return false;
+    }
+  }
+
+  /// @remarks The destination must be initialized (e.g. zeroed).
   void copy_from(const Basic_variant& rhs)
   {
-    const auto err = VariantCopyInd(&data_, &rhs.data_);
+    if (is_trivial(rhs.data_.vt)) {
+      data_ = rhs.data_;
+      return;
+    }
+    // VariantCopyInd() doesn't modify the source; the const_cast is
+    // forced by its pre-const-correctness signature.
+    const auto err = VariantCopyInd(&data_, const_cast<VARIANT*>(&rhs.data_));
     if (FAILED(err))
       // FIXME: use wincom::Win_error
       throw std::runtime_error{"cannot copy Variant"};
@@ -405,21 +482,24 @@ private:
     return bool(data_.vt & tp);
   }
 
-  [[noreturn]] static void throw_conversion_error(const std::string& tpnm)
+  [[noreturn]] static void throw_conversion_error(const std::string_view tpnm)
   {
-    throw std::logic_error{"cannot convert Variant to "+tpnm};
+    throw std::logic_error{std::string{"cannot convert Variant to "}
+      .append(tpnm)};
   }
 
-  void check(const VARENUM tp, const std::string& tpnm) const
+  void check(const VARENUM tp, const std::string_view tpnm) const
   {
-    if (!is(tp))
-      throw_conversion_error(tpnm);
+    if (is(tp)) [[likely]]
+      return;
+    throw_conversion_error(tpnm);
   }
 
-  void check_bits(const VARENUM tp, const std::string& tpnm) const
+  void check_bits(const VARENUM tp, const std::string_view tpnm) const
   {
-    if (!has(tp))
-      throw_conversion_error(tpnm);
+    if (has(tp)) [[likely]]
+      return;
+    throw_conversion_error(tpnm);
   }
 };
 
@@ -487,37 +567,47 @@ T to(const Basic_variant<IsConst, IsOwns>& variant, const USHORT flags = {})
 {
   using D = std::decay_t<T>;
   using std::is_same_v;
-  const auto var = variant.to_variant(detail::Variant_type_traits<T>::vt, flags);
-  if constexpr (is_same_v<D, bool>)
-    return var.as_bool();
-  else if constexpr (is_same_v<D, Date>)
-    return Date{var.as_date()};
-  else if constexpr (is_same_v<D, std::int8_t>)
-    return var.as_int8();
-  else if constexpr (is_same_v<D, std::uint8_t>)
-    return var.as_uint8();
-  else if constexpr (is_same_v<D, std::int16_t>)
-    return var.as_int16();
-  else if constexpr (is_same_v<D, std::uint16_t>)
-    return var.as_uint16();
-  else if constexpr (is_same_v<D, std::int32_t>)
-    return var.as_int32();
-  else if constexpr (is_same_v<D, std::uint32_t>)
-    return var.as_uint32();
-  else if constexpr (is_same_v<D, std::int64_t>)
-    return var.as_int64();
-  else if constexpr (is_same_v<D, std::uint64_t>)
-    return var.as_uint64();
-  else if constexpr (is_same_v<D, float>)
-    return var.as_real32();
-  else if constexpr (is_same_v<D, double>)
-    return var.as_real64();
-  else if constexpr (is_same_v<D, std::string>)
-    return var.as_string_utf8();
-  else if constexpr (is_same_v<D, std::wstring>)
-    return var.as_wstring();
-  else
-    static_assert(false_value<T>);
+  const auto as = [](const auto& var) -> T
+  {
+    if constexpr (is_same_v<D, bool>)
+      return var.as_bool();
+    else if constexpr (is_same_v<D, Date>)
+      return Date{var.as_date()};
+    else if constexpr (is_same_v<D, std::int8_t>)
+      return var.as_int8();
+    else if constexpr (is_same_v<D, std::uint8_t>)
+      return var.as_uint8();
+    else if constexpr (is_same_v<D, std::int16_t>)
+      return var.as_int16();
+    else if constexpr (is_same_v<D, std::uint16_t>)
+      return var.as_uint16();
+    else if constexpr (is_same_v<D, std::int32_t>)
+      return var.as_int32();
+    else if constexpr (is_same_v<D, std::uint32_t>)
+      return var.as_uint32();
+    else if constexpr (is_same_v<D, std::int64_t>)
+      return var.as_int64();
+    else if constexpr (is_same_v<D, std::uint64_t>)
+      return var.as_uint64();
+    else if constexpr (is_same_v<D, float>)
+      return var.as_real32();
+    else if constexpr (is_same_v<D, double>)
+      return var.as_real64();
+    else if constexpr (is_same_v<D, std::string>)
+      return var.as_string_utf8();
+    else if constexpr (is_same_v<D, std::wstring>)
+      return var.as_wstring();
+    else
+      static_assert(false_value<T>);
+  };
+  /*
+   * Read the value right out of `variant` when its type already matches:
+   * VariantChangeType (and the temporary it fills, cleared on return) is
+   * only involved for an actual coercion.
+   */
+  if (variant.type() == detail::Variant_type_traits<T>::vt) [[likely]]
+    return as(variant);
+  return as(variant.to_variant(detail::Variant_type_traits<T>::vt, flags));
 }
 
 // -----------------------------------------------------------------------------
@@ -546,14 +636,26 @@ public:
    *
    * @param vt The array elements type.
    * @param rgsa The bounds of each dimension of the array.
+   *
+   * @remarks SafeArrayCreate() only reads the bounds, so they are passed
+   * through as is: no heap-allocated copy at the construction site. (The
+   * const_cast is forced by the SafeArrayCreate() signature.)
    */
-  Basic_safe_array(const VARTYPE vt, std::vector<SAFEARRAYBOUND> rgsa)
-    : data_{SafeArrayCreate(vt, rgsa.size(), rgsa.data())}
+  Basic_safe_array(const VARTYPE vt, const std::span<const SAFEARRAYBOUND> rgsa)
+    : data_{SafeArrayCreate(vt, static_cast<UINT>(rgsa.size()),
+        const_cast<SAFEARRAYBOUND*>(rgsa.data()))}
   {
     if (!data_)
       throw std::runtime_error{"cannot create Safe_array"};
   }
 
+  /// @overload
+  Basic_safe_array(const VARTYPE vt,
+    const std::initializer_list<SAFEARRAYBOUND> rgsa)
+    : Basic_safe_array{vt,
+        std::span<const SAFEARRAYBOUND>{rgsa.begin(), rgsa.size()}}
+  {}
+
   /**
    * @brief Constructs an array.
    *
@@ -617,6 +719,7 @@ public:
   {
     using std::swap;
     swap(data_, rhs.data_);
+    swap(lock_depth_, rhs.lock_depth_);
   }
 
   // Forward declaration of an array slice.
@@ -632,10 +735,10 @@ public:
   template<bool IsConst>
   class Basic_slice final : Noncopymove {
   public:
-    /// Decrements the lock count of the array.
+    /// Unlocks the array if this is the last live slice.
     ~Basic_slice()
     {
-      if (self_.data_)
+      if (!--self_.lock_depth_ && self_.data_)
         SafeArrayUnlock(self_.data_);
     }
 
@@ -662,9 +765,9 @@ public:
         feat = FADF_VARIANT | FADF_HAVEVARTYPE;
       else
         static_assert(false_value<T>);
-      if (!bool(self_.features() & feat))
+      if (!bool(features_ & feat))
         throw std::runtime_error{"cannot get array of requested type"};
-      return static_cast<const T*>(self_.data().pvData) + absolute_offset_;
+      return static_cast<const T*>(elements_) + absolute_offset_;
     }
 
     /// @overload
@@ -701,21 +804,21 @@ public:
     }
 
     /// @returns The lower bound of this slice.
-    LONG lower_bound() const
+    LONG lower_bound() const noexcept
     {
-      return self_.data().rgsabound[dim_].lLbound;
+      return self_.data_unchecked().rgsabound[dim_].lLbound;
     }
 
     /// @returns `true` if this slice represents a vector.
-    bool is_vector() const
+    bool is_vector() const noexcept
     {
-      return dimension() == self_.dimension_count() - 1;
+      return dimension() == self_.data_unchecked().cDims - 1;
     }
 
     /// @returns The slice count.
-    std::size_t slice_count() const
+    std::size_t slice_count() const noexcept
     {
-      return !is_vector() * self_.data().rgsabound[dim_].cElements;
+      return !is_vector() * self_.data_unchecked().rgsabound[dim_].cElements;
     }
 
     /**
@@ -740,42 +843,58 @@ public:
 
     const Basic_safe_array& self_;
     USHORT dim_{};
+    // The descriptor scalars element reads touch, captured at construction:
+    // stable while the slice holds the lock, so array() chases no pointers.
+    USHORT features_{};
+    const void* elements_{};
     std::size_t absolute_offset_{};
     std::size_t size_{};
 
     template<class S>
     S make_slice(const std::size_t index) const
     {
-      const auto& data = self_.data();
+      const auto& data = self_.data_unchecked();
       if (!(dim_ + 1 < data.cDims))
         throw std::invalid_argument{"Safe_array dimension overflow"};
       else if (!(index < data.rgsabound[dim_].cElements))
         throw std::invalid_argument{"Safe_array index overflow"};
-      return S{self_, static_cast<USHORT>(dim_ + 1), index, absolute_offset_};
+      return S{self_, static_cast<USHORT>(dim_ + 1), index, absolute_offset_,
+        size_ / data.rgsabound[dim_].cElements};
     }
 
-    /// Increments the lock count of the array.
+    /**
+     * @brief Locks the array if this is the first live slice.
+     *
+     * @details Nested slices created while another slice is alive only
+     * bump the slice counter of the owner: SafeArrayLock()/
+     * SafeArrayUnlock() are entered once per traversal rather than once
+     * per slice.
+     *
+     * @param size The product of element counts of the dimensions in range
+     * `[dim, dimension count)`. The outermost slice gets it from
+     * Basic_safe_array::dimension_product(), the nested slices get it derived
+     * from the size of the parent slice, so it's never recomputed by loop.
+     */
     Basic_slice(const Basic_safe_array& self, const USHORT dim,
       const std::size_t slice_offset,
-      const std::size_t absolute_offset)
+      const std::size_t absolute_offset,
+      const std::size_t size)
       : self_{self}
       , dim_{dim}
+      , size_{size}
     {
-      {
+      if (self.lock_depth_++ == 0) {
         const auto err = SafeArrayLock(self.data_);
-        if (FAILED(err))
+        if (FAILED(err)) {
+          --self.lock_depth_;
           throw std::runtime_error{"cannot create Safe_array::Slice:"
             " cannot lock SAFEARRAY"};
+        }
       }
 
-      size_ = [&]
-      {
-        std::size_t result{1};
-        const USHORT dcount{self_.dimension_count()};
-        for (USHORT d{dim_}; d < dcount; ++d)
-          result *= self_.data().rgsabound[d].cElements;
-        return result;
-      }();
+      const auto& data = self.data_unchecked();
+      features_ = data.fFeatures;
+      elements_ = data.pvData;
       absolute_offset_ = absolute_offset + slice_offset*size_;
     }
   };
@@ -817,20 +936,47 @@ public:
   }
 
   /**
-   * @brief Increments the lock count of the underying array.
+   * @brief Locks the underying array unless it's locked by a live slice.
    *
    * @returns The slice of zero dimension.
    */
   Const_slice slice() const
   {
-    return Const_slice{*this, 0, 0, 0};
+    return Const_slice{*this, 0, 0, 0, dimension_product(0)};
   }
 
   /// @overload
   Slice slice()
   {
     static_assert(!IsConst);
-    return Slice{*this, 0, 0, 0};
+    return Slice{*this, 0, 0, 0, dimension_product(0)};
+  }
+
+  /**
+   * @brief Copies the elements out into `dst`.
+   *
+   * @returns The number of elements copied.
+   *
+   * @details A SAFEARRAY of a scalar VARTYPE stores its elements packed,
+   * so the copy is a single memcpy off pvData under the lock: no
+   * per-element extraction, type checks or branches. (Arrays of
+   * VARIANT-wrapped elements are covered by to_vector().)
+   *
+   * @throws std::runtime_error if the VARTYPE of the array doesn't
+   * match `T`.
+   */
+  template<typename T>
+  std::size_t copy_out(const std::span<T> dst) const
+  {
+    static_assert(std::is_arithmetic_v<T>);
+    if (vartype() != detail::Variant_type_traits<T>::vt ||
+      element_size() != sizeof(T))
+      throw std::runtime_error{"cannot copy Safe_array elements:"
+        " element type mismatch"};
+    const auto locked = slice();
+    const auto size = std::min(locked.size(), dst.size());
+    std::memcpy(dst.data(), data().pvData, size*sizeof(T));
+    return size;
   }
 
   /// @returns The underlying data.
@@ -863,6 +1009,30 @@ public:
 
 private:
   SAFEARRAY* data_{};
+  /// The number of live slices. The array is kept locked while it's nonzero.
+  mutable unsigned lock_depth_{};
+
+  /**
+   * @returns The underlying data which is assumed to be valid.
+   *
+   * @remarks For use on paths where `data_` is known to be non-null, e.g.
+   * from a live slice (whose constructor locked the array): no null check
+   * and no potential throw, so such callers can be noexcept and inlined.
+   */
+  const SAFEARRAY& data_unchecked() const noexcept
+  {
+    return *data_;
+  }
+
+  /// @returns The product of element counts of dimensions starting from `dim`.
+  std::size_t dimension_product(const USHORT dim) const
+  {
+    std::size_t result{1};
+    const auto& dat = data();
+    for (USHORT d{dim}; d < dat.cDims; ++d)
+      result *= dat.rgsabound[d].cElements;
+    return result;
+  }
 
   void copy_from(Basic_safe_array& rhs)
   {
@@ -894,4 +1064,30 @@ Safe_array_view Basic_variant<IsConst, IsOwns>::as_array()
   return Safe_array_view{data_.parray};
 }
 
+/**
+ * @param array The array of VARIANT elements.
+ * @param flags Flags which are passed to Basic_variant::to_variant().
+ *
+ * @returns The values of type `T` coerced from the elements of `array`.
+ *
+ * @details The SAFEARRAY lock and the feature check of
+ * Basic_safe_array::Basic_slice::array() are hoisted out of the loop: the
+ * elements are read right off the contiguous VARIANT storage, and the
+ * elements whose type already matches `T` involve no coercion machinery
+ * at all.
+ */
+template<typename T, bool IsConst, bool IsOwns>
+std::vector<T> to_vector(const Basic_safe_array<IsConst, IsOwns>& array,
+  const USHORT flags = {})
+{
+  const auto slice = array.slice();
+  const VARIANT* const elements = slice.template array<VARIANT>();
+  const std::size_t size{slice.size()};
+  std::vector<T> result;
+  result.reserve(size);
+  for (std::size_t i{}; i < size; ++i)
+    result.push_back(to<T>(Const_variant_view{elements[i]}, flags));
+  return result;
+}
+
 } // namespace dmitigr::winbase::com
@@ -19,6 +19,7 @@
 #include "windows.hpp"
 #include "error.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 
@@ -34,7 +35,19 @@ struct Dialog final {
 inline std::wstring dialog_item_text(const HWND dlg, const int item_id,
   const UINT max_size)
 {
-  std::wstring result(max_size, '\0');
+  // Size the result from the actual text length rather than from max_size:
+  // no zero-fill of a max_size-wchar buffer per call.
+  const HWND item{GetDlgItem(dlg, item_id)};
+  if (!item)
+    throw std::runtime_error{last_error_message()};
+  SetLastError(0);
+  const auto text_size = static_cast<UINT>(GetWindowTextLengthW(item));
+  if (!text_size) {
+    if (const auto err = GetLastError())
+      throw std::runtime_error{system_message(err)};
+    return std::wstring{};
+  }
+  std::wstring result(std::min(text_size, max_size), '\0');
   const UINT result_size{GetDlgItemTextW(dlg, item_id,
       result.data(), result.size() + 1)};
   if (!result_size) {
@@ -22,6 +22,7 @@
 
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace dmitigr::winbase {
 
@@ -31,19 +32,50 @@ inline DWORD last_error() noexcept
   return GetLastError();
 }
 
-/// @returns A human-readable system message in UTF-16.
-inline std::wstring system_message_w(const DWORD message_id)
+namespace detail {
+
+/**
+ * @returns The result of `callback` invoked with the UTF-16 system message.
+ *
+ * @details System messages are short, so the message is formatted into a
+ * stack buffer first: no LocalAlloc/LocalFree round trip of
+ * FORMAT_MESSAGE_ALLOCATE_BUFFER on the common path. The allocating
+ * variant remains as a fallback for messages the stack buffer cannot fit.
+ * The callback lets the caller convert the message to its final
+ * representation directly, with no intermediate std::wstring.
+ */
+template<typename F>
+auto with_system_message_w(const DWORD message_id, const F& callback)
 {
-  LPWSTR buffer{};
-  const auto buffer_size = FormatMessageW(
-    FORMAT_MESSAGE_ALLOCATE_BUFFER |
+  constexpr DWORD flags{
     FORMAT_MESSAGE_FROM_SYSTEM |
     FORMAT_MESSAGE_IGNORE_INSERTS |
-    FORMAT_MESSAGE_MAX_WIDTH_MASK,
+    FORMAT_MESSAGE_MAX_WIDTH_MASK};
+  constexpr DWORD lang{MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT)};
+  // constexpr DWORD lang{MAKELANGID(LANG_ENGLISH, SUBLANG_ENGLISH_US)};
+
+  constexpr DWORD stack_size{512};
+  wchar_t stack[stack_size];
+  if (const auto size = FormatMessageW(
+      flags,
+      nullptr,
+      message_id,
+      lang,
+      stack,
+      stack_size,
+      nullptr))
+    return callback(std::wstring_view{stack, size});
+  else if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+    throw std::runtime_error{"cannot create system error message:"
+      " error " + std::to_string(GetLastError())};
+  }
+
+  LPWSTR buffer{};
+  const auto buffer_size = FormatMessageW(
+    flags | FORMAT_MESSAGE_ALLOCATE_BUFFER,
     nullptr,
     message_id,
-    MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-    // MAKELANGID(LANG_ENGLISH, SUBLANG_ENGLISH_US),
+    lang,
     reinterpret_cast<LPWSTR>(&buffer),
     0,
     nullptr);
@@ -53,13 +85,28 @@ inline std::wstring system_message_w(const DWORD message_id)
   }
 
   const Hlocal_guard guard{buffer};
-  return std::wstring{buffer, buffer_size};
+  return callback(std::wstring_view{buffer, buffer_size});
 }
 
+} // namespace detail
+
 /// @returns A human-readable system message in UTF-16.
+inline std::wstring system_message_w(const DWORD message_id)
+{
+  return detail::with_system_message_w(message_id,
+    [](const std::wstring_view msg){return std::wstring{msg};});
+}
+
+/**
+ * @returns A human-readable system message in UTF-8.
+ *
+ * @remarks Re-encodes the formatted message right away: no UTF-16 string
+ * is materialized in between.
+ */
 inline std::string system_message(const DWORD message_id)
 {
-  return utf16_to_utf8(system_message_w(message_id));
+  return detail::with_system_message_w(message_id,
+    [](const std::wstring_view msg){return utf16_to_utf8(msg);});
 }
 
 /// @returns A human-readable message from GetLastError() in UTF-16.
@@ -71,7 +118,7 @@ inline std::wstring last_error_message_w()
 /// @returns A human-readable message from GetLastError() in UTF-8.
 inline std::string last_error_message()
 {
-  return utf16_to_utf8(last_error_message_w());
+  return system_message(GetLastError());
 }
 
 } // namespace dmitigr::winbase
@@ -24,88 +24,122 @@
 
 namespace dmitigr::winbase {
 
-/// A very thin wrapper around the HANDLE data type.
-class Handle_guard final : private Noncopy {
+/**
+ * @brief A very thin wrapper around a handle of type `Traits::Handle`.
+ *
+ * @details The `Traits` must provide:
+ *   - the alias `Handle` of the handle type;
+ *   - `static Handle sentinel() noexcept` - the value of an empty guard;
+ *   - `static bool destroy(Handle) noexcept` - the handle destruction which
+ *   returns `true` on success.
+ */
+template<class Traits>
+class Basic_guard final : private Noncopy {
 public:
+  /// An alias of the handle type.
+  using Handle = typename Traits::Handle;
+
   /// The destructor.
-  ~Handle_guard()
+  ~Basic_guard()
   {
     close();
   }
 
   /// The default constructor.
-  Handle_guard() noexcept = default;
+  Basic_guard() noexcept = default;
 
   /// The constructor.
-  explicit Handle_guard(const HANDLE handle) noexcept
+  explicit Basic_guard(const Handle handle) noexcept
     : handle_{handle}
   {}
 
   /// The move constructor.
-  Handle_guard(Handle_guard&& rhs) noexcept
+  Basic_guard(Basic_guard&& rhs) noexcept
     : handle_{rhs.handle_}
   {
-    rhs.handle_ = INVALID_HANDLE_VALUE;
+    rhs.handle_ = Traits::sentinel();
   }
 
   /// The move assignment operator.
-  Handle_guard& operator=(Handle_guard&& rhs) noexcept
+  Basic_guard& operator=(Basic_guard&& rhs) noexcept
   {
+    // Close and take over directly - no temporary, no swap dance.
     if (this != &rhs) {
-      Handle_guard tmp{std::move(rhs)};
-      swap(tmp);
+      close();
+      handle_ = rhs.handle_;
+      rhs.handle_ = Traits::sentinel();
     }
     return *this;
   }
 
   /// The swap operation.
-  void swap(Handle_guard& other) noexcept
+  void swap(Basic_guard& other) noexcept
   {
     using std::swap;
     swap(handle_, other.handle_);
   }
 
-  /// @returns The guarded HANDLE.
-  HANDLE handle() const noexcept
+  /// @returns The guarded handle.
+  Handle handle() const noexcept
   {
     return handle_;
   }
 
-  /// @returns The guarded HANDLE.
-  operator HANDLE() const noexcept
+  /// @returns The guarded handle.
+  operator Handle() const noexcept
   {
     return handle();
   }
 
-  /// @returns `true` if the guarded HANDLE is valid.
+  /// @returns `true` if the guarded handle is valid.
   explicit operator bool() const noexcept
   {
-    return handle_ != INVALID_HANDLE_VALUE;
+    return handle_ != Traits::sentinel();
   }
 
   /// @returns The error code.
   DWORD close() noexcept
   {
-    DWORD result{ERROR_SUCCESS};
-    if (handle_ != INVALID_HANDLE_VALUE) {
-      if (CloseHandle(handle_))
-        handle_ = INVALID_HANDLE_VALUE;
-      else
-        result = GetLastError();
-    }
-    return result;
+    if (handle_ == Traits::sentinel())
+      return ERROR_SUCCESS;
+    else if (Traits::destroy(handle_)) [[likely]] {
+      handle_ = Traits::sentinel();
+      return ERROR_SUCCESS;
+    } else
+      return GetLastError();
   }
 
   /// @returns The released handle.
-  HANDLE release() noexcept
+  Handle release() noexcept
   {
     auto result = handle_;
-    handle_ = INVALID_HANDLE_VALUE;
+    handle_ = Traits::sentinel();
     return result;
   }
 
 private:
-  HANDLE handle_{INVALID_HANDLE_VALUE};
+  Handle handle_{Traits::sentinel()};
+};
+
+/// The guard traits of the HANDLE data type.
+struct Handle_guard_traits final {
+  /// An alias of the handle type.
+  using Handle = HANDLE;
+
+  /// @returns The value of an empty guard.
+  static Handle sentinel() noexcept
+  {
+    return INVALID_HANDLE_VALUE;
+  }
+
+  /// @returns `true` on success.
+  static bool destroy(const Handle handle) noexcept
+  {
+    return CloseHandle(handle);
+  }
 };
 
+/// A very thin wrapper around the HANDLE data type.
+using Handle_guard = Basic_guard<Handle_guard_traits>;
+
 } // namespace dmitigr::winbase
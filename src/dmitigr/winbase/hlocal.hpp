@@ -16,79 +16,30 @@
 
 #pragma once
 
-#include "../base/noncopymove.hpp"
-#include "windows.hpp"
-
-#include <algorithm>
-#include <utility>
+#include "hguard.hpp"
 
 namespace dmitigr::winbase {
 
-/// A very thin wrapper around the HLOCAL data type.
-class Hlocal_guard final : private Noncopy {
-public:
-  /// The destructor.
-  ~Hlocal_guard()
-  {
-    close();
-  }
-
-  /// The constructor.
-  explicit Hlocal_guard(const HLOCAL handle = NULL) noexcept
-    : handle_{handle}
-  {}
-
-  /// The move constructor.
-  Hlocal_guard(Hlocal_guard&& rhs) noexcept
-    : handle_{rhs.handle_}
-  {
-    rhs.handle_ = NULL;
-  }
-
-  /// The move assignment operator.
-  Hlocal_guard& operator=(Hlocal_guard&& rhs) noexcept
-  {
-    if (this != &rhs) {
-      Hlocal_guard tmp{std::move(rhs)};
-      swap(tmp);
-    }
-    return *this;
-  }
-
-  /// The swap operation.
-  void swap(Hlocal_guard& other) noexcept
-  {
-    using std::swap;
-    swap(handle_, other.handle_);
-  }
-
-  /// @returns The guarded HLOCAL.
-  HLOCAL handle() const noexcept
-  {
-    return handle_;
-  }
+/// The guard traits of the HLOCAL data type.
+struct Hlocal_guard_traits final {
+  /// An alias of the handle type.
+  using Handle = HLOCAL;
 
-  /// @returns The guarded HLOCAL.
-  operator HLOCAL() const noexcept
+  /// @returns The value of an empty guard.
+  static Handle sentinel() noexcept
   {
-    return handle();
+    return NULL;
   }
 
-  /// @returns The error code.
-  DWORD close() noexcept
+  /// @returns `true` on success.
+  static bool destroy(const Handle handle) noexcept
   {
-    DWORD result{ERROR_SUCCESS};
-    if (handle_ != NULL) {
-      if (!LocalFree(handle_))
-        handle_ = NULL;
-      else
-        result = GetLastError();
-    }
-    return result;
+    // LocalFree() returns NULL on success.
+    return !LocalFree(handle);
   }
-
-private:
-  HLOCAL handle_{NULL};
 };
 
+/// A very thin wrapper around the HLOCAL data type.
+using Hlocal_guard = Basic_guard<Hlocal_guard_traits>;
+
 } // namespace dmitigr::winbase
@@ -20,13 +20,16 @@
 #include "windows.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <future>
+#include <list>
 #include <memory>
-#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -35,6 +38,59 @@
 
 namespace dmitigr::winbase::ipc::wm {
 
+namespace detail {
+
+/**
+ * @brief A lock_guard-style RAII wrapper around SRWLOCK.
+ *
+ * @details SRWLOCK acquisition stays in user mode when uncontended, unlike
+ * std::mutex whose implementation may transition to the kernel: the locks
+ * here guard a few pointer-sized fields and a map lookup, so the
+ * uncontended case dominates.
+ */
+class [[nodiscard]] Srw_exclusive_guard final {
+public:
+  ~Srw_exclusive_guard()
+  {
+    ReleaseSRWLockExclusive(&lock_);
+  }
+
+  explicit Srw_exclusive_guard(SRWLOCK& lock) noexcept
+    : lock_{lock}
+  {
+    AcquireSRWLockExclusive(&lock_);
+  }
+
+  Srw_exclusive_guard(const Srw_exclusive_guard&) = delete;
+  Srw_exclusive_guard& operator=(const Srw_exclusive_guard&) = delete;
+
+private:
+  SRWLOCK& lock_;
+};
+
+/// The shared (read-only) counterpart of Srw_exclusive_guard.
+class [[nodiscard]] Srw_shared_guard final {
+public:
+  ~Srw_shared_guard()
+  {
+    ReleaseSRWLockShared(&lock_);
+  }
+
+  explicit Srw_shared_guard(SRWLOCK& lock) noexcept
+    : lock_{lock}
+  {
+    AcquireSRWLockShared(&lock_);
+  }
+
+  Srw_shared_guard(const Srw_shared_guard&) = delete;
+  Srw_shared_guard& operator=(const Srw_shared_guard&) = delete;
+
+private:
+  SRWLOCK& lock_;
+};
+
+} // namespace detail
+
 class Messenger final {
 public:
   /**
@@ -53,9 +109,18 @@ public:
     stop();
   }
 
-  void init(const std::wstring& clss, Handler handler, HINSTANCE instance = {})
+  /**
+   * @brief Initializes the messenger.
+   *
+   * @param expected_pending A hint of how many responses are expected to be
+   * in flight at a time. The pending-response maps are pre-sized for it (at
+   * half load), so the hot send/reply paths neither rehash nor chase long
+   * bucket chains.
+   */
+  void init(const std::wstring& clss, Handler handler, HINSTANCE instance = {},
+    const std::size_t expected_pending = 256)
   {
-    const std::lock_guard lg{mutex_};
+    const detail::Srw_exclusive_guard lg{mutex_};
 
     if (!handler)
       throw std::invalid_argument{"cannot initialize ipc::wm::Messenger: "
@@ -66,28 +131,31 @@ public:
     else if (!instance)
       instance = GetModuleHandleW(nullptr);
 
-    if (!register_window(instance, clss))
+    clss_atom_ = register_window(instance, clss);
+    if (!clss_atom_)
       throw std::runtime_error{"cannot register message class of ipc::wm::Messenger:" +
         last_error_message()};
 
-    clss_ = clss;
+    for (auto& sh : pending_responses_) {
+      sh.map.max_load_factor(.5f);
+      sh.map.reserve(std::max<std::size_t>(expected_pending / shard_count_, 8));
+    }
+
     instance_ = instance;
-    handler_ = [handle = std::move(handler)](const HWND sender,
-      const std::string_view message, const int format)
-        -> std::unique_ptr<ipc::Response>
-      {
-        try {
-          return handle(sender, message, format);
-        } catch (...) {}
-        return nullptr;
-      };
+    /*
+     * Stored as passed: wrapping the handler into another lambda (as done
+     * before) would capture a std::function inside a std::function - an
+     * extra indirection plus a guaranteed heap allocation, paid on every
+     * WM_COPYDATA. The try/catch shield lives at the call site instead.
+     */
+    handler_ = std::move(handler);
   }
 
   int run()
   {
     const auto main = [this]
     {
-      const std::lock_guard lg{mutex_};
+      const detail::Srw_exclusive_guard lg{mutex_};
 
       if (!instance_)
         throw std::logic_error{"instance ipc::wm::Messenger not initialized"};
@@ -95,11 +163,13 @@ public:
       if (window_)
         throw std::logic_error{"instance ipc::wm::Messenger already running"};
 
-      assert(!clss_.empty());
+      assert(clss_atom_);
 
+      // The atom spares USER32 a class-name lookup per window creation and
+      // the messenger the need to keep the class name alive.
       window_ = CreateWindowExW(
         0,
-        clss_.c_str(), nullptr,
+        MAKEINTATOM(clss_atom_), nullptr,
         0, 0, 0, 0, 0,
         HWND_MESSAGE,
         nullptr,
@@ -116,20 +186,32 @@ public:
       return window_;
     }();
 
-    if (!SetTimer(main, cleanup_timer_id_, 1000, nullptr)) {
-      const auto errmsg = last_error_message();
-      stop();
-      throw std::runtime_error{"cannot start cleanup timer of ipc::wm::Messenger: "
-        + errmsg};
-    }
-
-    MSG msg;
+    /*
+     * Instead of a periodic timer the loop sleeps until either input
+     * arrives or the oldest pending response expires: an idle messenger
+     * generates no wakeups at all.
+     */
+    MSG msg{};
     while (true) {
-      msg = {};
-      if (const int r{GetMessage(&msg, main, 0, 0)}; r == -1 || r == 0)
+      const auto r = MsgWaitForMultipleObjectsEx(0, nullptr,
+        next_cleanup_timeout(), QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+      if (r == WAIT_FAILED)
+        break;
+      else if (r == WAIT_TIMEOUT) {
+        cleanup_expired();
+        continue;
+      }
+      bool quit{};
+      while (PeekMessageW(&msg, main, 0, 0, PM_REMOVE)) {
+        if (msg.message == WM_QUIT) {
+          quit = true;
+          break;
+        }
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+      }
+      if (quit)
         break;
-      TranslateMessage(&msg);
-      DispatchMessage(&msg);
     }
 
     return static_cast<int>(msg.wParam);
@@ -137,36 +219,77 @@ public:
 
   void stop() noexcept
   {
-    const std::lock_guard lg{mutex_};
+    const detail::Srw_exclusive_guard lg{mutex_};
     if (window_) {
-      KillTimer(window_, cleanup_timer_id_);
       DestroyWindow(window_);
       window_ = {};
     }
-    assert(!is_running());
+    // Checked directly: is_running() would reacquire the non-recursive lock.
+    assert(!window_);
   }
 
   bool is_running() noexcept
   {
-    const std::lock_guard lg{mutex_};
+    const detail::Srw_shared_guard lg{mutex_};
     return static_cast<bool>(window_);
   }
 
-  void send(const HWND window, const ipc::Response& response)
+  /**
+   * @brief Sends `response` to `window`.
+   *
+   * @param timeout The delivery timeout. `std::nullopt` means waiting for
+   * the recipient indefinitely, as SendMessage() does; otherwise the wait
+   * is bounded (and aborted right away if the recipient hangs), so a dead
+   * peer cannot stall the calling thread.
+   */
+  void send(const HWND window, const ipc::Response& response,
+    const std::optional<std::chrono::milliseconds> timeout = {})
   {
-    const std::lock_guard lg{mutex_};
-    send__(window, response);
+    const detail::Srw_exclusive_guard lg{mutex_};
+    send__(window, response, timeout);
   }
 
+  /// @overload
   [[nodiscard]] std::future<std::unique_ptr<ipc::Response>>
-  send(const HWND window, const ipc::Request& request)
+  send(const HWND window, const ipc::Request& request,
+    const std::optional<std::chrono::milliseconds> timeout = {})
   {
-    const std::lock_guard lg{mutex_};
-    send__(window, request);
-    return (pending_responses_[request.id()] = Pending_response{
-      std::chrono::steady_clock::now(),
-      window,
-      std::promise<std::unique_ptr<ipc::Response>>{}}).promise.get_future();
+    /*
+     * Register the pending response before sending: with the map no longer
+     * behind the global lock, the reply may be dispatched on the messenger
+     * thread before send__() returns.
+     */
+    const auto id = request.id();
+    auto future = [&]
+    {
+      auto& sh = shard(id);
+      const detail::Srw_exclusive_guard lg{sh.mutex};
+      const auto [it, inserted] = sh.map.try_emplace(id);
+      if (!inserted)
+        sh.order.erase(it->second.order_iter);
+      it->second = Pending_response{
+        std::chrono::steady_clock::now(),
+        window,
+        std::promise<std::unique_ptr<ipc::Response>>{}};
+      it->second.order_iter = sh.order.insert(sh.order.cend(), id);
+      return it->second.promise.get_future();
+    }();
+    try {
+      const detail::Srw_exclusive_guard lg{mutex_};
+      send__(window, request, timeout);
+      // Nudge the run() loop so it recomputes its cleanup deadline, which
+      // may currently be INFINITE if this is the only pending response.
+      PostMessageW(window_, WM_NULL, 0, 0);
+    } catch (...) {
+      auto& sh = shard(id);
+      const detail::Srw_exclusive_guard lg{sh.mutex};
+      if (const auto it = sh.map.find(id); it != sh.map.cend()) {
+        sh.order.erase(it->second.order_iter);
+        sh.map.erase(it);
+      }
+      throw;
+    }
+    return future;
   }
 
 private:
@@ -174,17 +297,101 @@ private:
     std::chrono::time_point<std::chrono::steady_clock> creation_time;
     HWND responder{};
     std::promise<std::unique_ptr<ipc::Response>> promise;
+    std::list<std::int64_t>::iterator order_iter;
+  };
+
+  /**
+   * @brief A cheap hash for the internally generated message identifiers.
+   *
+   * @details One multiply plus a fold of the high half into the low half,
+   * instead of the byte-wise FNV loop of MSVC std::hash. A pure identity
+   * hash would be cheaper still but clusters here: the ids within a shard
+   * share their low bits by construction (the shard is picked by id
+   * modulo the shard count), and power-of-two bucketing keys on exactly
+   * those bits.
+   */
+  struct Id_hash final {
+    std::size_t operator()(const std::int64_t id) const noexcept
+    {
+      const auto h = static_cast<std::uint64_t>(id) * 0x9e3779b97f4a7c15ull;
+      return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+  };
+
+  /**
+   * @brief A contention domain of the pending-response map.
+   *
+   * @details The map is striped by message identifier so that concurrent
+   * senders and the WM_COPYDATA reply path rarely collide on the same
+   * lock; the global mutex_ only guards the messenger state.
+   */
+  struct Shard final {
+    SRWLOCK mutex = SRWLOCK_INIT;
+    std::unordered_map<std::int64_t, Pending_response, Id_hash> map;
+    /// The identifiers ordered by creation time (entries are appended as
+    /// they are created): the sweep pops expired entries from the front
+    /// and stops at the first live one instead of scanning the whole map.
+    std::list<std::int64_t> order;
   };
 
   Handler handler_;
-  std::wstring clss_;
+  ATOM clss_atom_{};
   HINSTANCE instance_;
-  constexpr static const UINT_PTR cleanup_timer_id_{1};
+  constexpr static const std::chrono::minutes pending_response_ttl_{1};
 
-  std::mutex mutex_;
+  SRWLOCK mutex_ = SRWLOCK_INIT;
   HWND window_;
   bool is_running_{};
-  std::unordered_map<std::int64_t, Pending_response> pending_responses_;
+  constexpr static const std::size_t shard_count_{16};
+  std::array<Shard, shard_count_> pending_responses_;
+
+  Shard& shard(const std::int64_t id) noexcept
+  {
+    return pending_responses_[static_cast<std::uint64_t>(id) % shard_count_];
+  }
+
+  /**
+   * @returns The milliseconds until the oldest pending response expires,
+   * or `INFINITE` if there are no pending responses.
+   */
+  DWORD next_cleanup_timeout() noexcept
+  {
+    using std::chrono::steady_clock;
+    auto oldest = steady_clock::time_point::max();
+    for (auto& sh : pending_responses_) {
+      const detail::Srw_shared_guard lg{sh.mutex};
+      if (!sh.order.empty()) {
+        const auto it = sh.map.find(sh.order.front());
+        assert(it != sh.map.cend());
+        oldest = std::min(oldest, it->second.creation_time);
+      }
+    }
+    if (oldest == steady_clock::time_point::max())
+      return INFINITE;
+    const auto left = oldest + pending_response_ttl_ - steady_clock::now();
+    if (left <= decltype(left)::zero())
+      return 0;
+    using std::chrono::milliseconds, std::chrono::ceil;
+    return static_cast<DWORD>(ceil<milliseconds>(left).count());
+  }
+
+  /// Removes the pending responses which will never be satisfied.
+  void cleanup_expired()
+  {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& sh : pending_responses_) {
+      const detail::Srw_exclusive_guard lg{sh.mutex};
+      while (!sh.order.empty()) {
+        const auto it = sh.map.find(sh.order.front());
+        assert(it != sh.map.cend());
+        if (now - it->second.creation_time > pending_response_ttl_) {
+          sh.map.erase(it);
+          sh.order.pop_front();
+        } else
+          break;
+      }
+    }
+  }
 
   static ATOM register_window(const HINSTANCE instance, const std::wstring& clss)
   {
@@ -221,24 +428,42 @@ private:
       }
       break;
     case WM_COPYDATA:
-      {
+      [[likely]] {
         auto* const self = instance(window);
         const auto sender = reinterpret_cast<HWND>(wparam);
         const auto* const cds = reinterpret_cast<COPYDATASTRUCT*>(lparam);
-        auto response = self->handler_(sender, std::string_view{
-          static_cast<char*>(cds->lpData),
-          static_cast<std::string_view::size_type>(cds->cbData)}, cds->dwData);
+        auto response = [self, sender, cds]() noexcept
+          -> std::unique_ptr<ipc::Response>
+        {
+          try {
+            return self->handler_(sender, std::string_view{
+              static_cast<char*>(cds->lpData),
+              static_cast<std::string_view::size_type>(cds->cbData)},
+              cds->dwData);
+          } catch (...) {}
+          return nullptr;
+        }();
         if (response) {
-          const std::lock_guard lg{self->mutex_};
-          if (const auto it = self->pending_responses_.find(response->id());
-            it != self->pending_responses_.cend() && it->second.responder == sender) {
+          auto& sh = self->shard(response->id());
+          /*
+           * Warm the shard (its lock word and map header share a line)
+           * and resolve the response type while the prefetch is in
+           * flight. The map nodes themselves can't be touched before
+           * the lock is held.
+           */
+          PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, &sh);
+          const bool error{response->is_error()};
+          const detail::Srw_exclusive_guard lg{sh.mutex};
+          if (const auto it = sh.map.find(response->id());
+            it != sh.map.cend() && it->second.responder == sender) {
             /*
              * We can't assert it because we can get the pending response too late -
-             * after the promise is removed from self->pending_responses_ by WM_TIMER.
+             * after the promise is removed from self->pending_responses_ by
+             * the cleanup sweep.
              */
-            if (const auto* const error = dynamic_cast<ipc::Error*>(response.get())) {
+            if (error) {
               try {
-                error->throw_from_this();
+                static_cast<const ipc::Error&>(*response).throw_from_this();
               } catch (...) {
                 try {
                   it->second.promise.set_exception(std::current_exception());
@@ -248,29 +473,12 @@ private:
               }
             } else
               it->second.promise.set_value(std::move(response));
-            self->pending_responses_.erase(it);
+            sh.order.erase(it->second.order_iter);
+            sh.map.erase(it);
           }
         }
       }
       return true;
-    case WM_TIMER:
-      if (wparam == cleanup_timer_id_) {
-        auto* const self = instance(window);
-        const std::lock_guard lg{self->mutex_};
-        while (true) {
-          const auto it = find_if(self->pending_responses_.begin(),
-            self->pending_responses_.end(),
-            [now = std::chrono::steady_clock::now()](const auto& pr)
-            {
-              return now - pr.second.creation_time > std::chrono::minutes{1};
-            });
-          if (it != self->pending_responses_.cend())
-            self->pending_responses_.erase(it);
-          else
-            break;
-        }
-      }
-      break;
     case WM_DESTROY:
       {
         SetWindowLongPtrW(window, GWLP_USERDATA, 0);
@@ -283,11 +491,12 @@ private:
     return 0;
   }
 
-  void send__(const HWND recipient, const ipc::Message& message)
+  void send__(const HWND recipient, const ipc::Message& message,
+    const std::optional<std::chrono::milliseconds> timeout)
   {
-    if (!window_)
+    if (!window_) [[unlikely]]
       throw std::runtime_error{"cannot send message: ipc::wm::Messenger not running"};
-    else if (!message.id())
+    else if (!message.id()) [[unlikely]]
       throw std::runtime_error{"cannot send message: invalid message identifier"};
 
     auto [fmt, data] = message.to_serialized();
@@ -295,11 +504,25 @@ private:
     cds.dwData = static_cast<ULONG_PTR>(fmt);
     cds.cbData = static_cast<DWORD>(data.size());
     cds.lpData = static_cast<PVOID>(data.data());
-    SendMessage(recipient, WM_COPYDATA,
-      reinterpret_cast<WPARAM>(window_),
-      reinterpret_cast<LPARAM>(static_cast<LPVOID>(&cds)));
-    if (const auto err = GetLastError())
-      throw std::runtime_error{system_message(err)};
+    if (timeout) {
+      DWORD_PTR unused{};
+      if (!SendMessageTimeoutW(recipient, WM_COPYDATA,
+          reinterpret_cast<WPARAM>(window_),
+          reinterpret_cast<LPARAM>(static_cast<LPVOID>(&cds)),
+          SMTO_ABORTIFHUNG | SMTO_NOTIMEOUTIFNOTHUNG,
+          static_cast<UINT>(timeout->count()), &unused)) [[unlikely]] {
+        const auto err = GetLastError();
+        if (err == ERROR_TIMEOUT)
+          throw std::runtime_error{"cannot send message: recipient timed out"};
+        throw std::runtime_error{system_message(err)};
+      }
+    } else {
+      SendMessage(recipient, WM_COPYDATA,
+        reinterpret_cast<WPARAM>(window_),
+        reinterpret_cast<LPARAM>(static_cast<LPVOID>(&cds)));
+      if (const auto err = GetLastError()) [[unlikely]]
+        throw std::runtime_error{system_message(err)};
+    }
   }
 };
 
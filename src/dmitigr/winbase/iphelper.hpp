@@ -45,20 +45,28 @@ public:
   static Ip_adapter_addresses from_system(const ULONG family, const ULONG flags)
   {
     constexpr PVOID reserved{};
-    ULONG size{};
-    if (const auto e = GetAdaptersAddresses(
-        family, flags, reserved, nullptr, &size); e != ERROR_BUFFER_OVERFLOW)
-      throw Sys_exception{e, "cannot determine size to retrieve network adapters"
-        " addresses"};
-
+    /*
+     * Start from the 15 KB working buffer the GetAdaptersAddresses()
+     * documentation recommends: it's sufficient on typical hosts, making the
+     * common case a single call instead of a size query followed by a
+     * retrieval (between which the adapter set may change anyway).
+     */
+    ULONG size{15 * 1024};
     Ip_adapter_addresses result;
-    if (size) {
+    for (int attempt{}; attempt < 3; ++attempt) {
       result.data_.resize(size);
-      if (const auto e = GetAdaptersAddresses(
-          family, flags, reserved, result.head(), &size))
+      const auto e = GetAdaptersAddresses(
+        family, flags, reserved, result.head(), &size);
+      if (e == ERROR_SUCCESS) [[likely]]
+        return result;
+      else if (e == ERROR_NO_DATA) {
+        result.data_.clear();
+        return result;
+      } else if (e != ERROR_BUFFER_OVERFLOW) [[unlikely]]
         throw Sys_exception{e, "cannot retrieve network adapters addresses"};
     }
-    return result;
+    throw Sys_exception{ERROR_BUFFER_OVERFLOW,
+      "cannot retrieve network adapters addresses"};
   }
 
   /// @returns `true` is the instance is valid.
@@ -16,79 +16,49 @@
 
 #pragma once
 
-#include "../base/noncopymove.hpp"
-#include "windows.hpp"
+#include "hguard.hpp"
 #include "strconv.hpp"
 
 #include <limits>
+#include <span>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 
 namespace dmitigr::winbase {
 
-class Menu_guard final : private Noncopy {
-public:
-  ~Menu_guard()
-  {
-    if (handle_) {
-      DestroyMenu(handle_);
-      handle_ = {};
-    }
-  }
-
-  Menu_guard() = default;
-
-  explicit Menu_guard(HMENU handle)
-    : handle_{handle}
-  {}
-
-  Menu_guard(Menu_guard&& rhs) noexcept
-    : handle_{rhs.handle_}
-  {
-    rhs.handle_ = {};
-  }
-
-  Menu_guard& operator=(Menu_guard&& rhs) noexcept
-  {
-    Menu_guard tmp{std::move(rhs)};
-    swap(tmp);
-    return *this;
-  }
-
-  void swap(Menu_guard& rhs) noexcept
-  {
-    using std::swap;
-    swap(handle_, rhs.handle_);
-  }
-
-  HMENU release() noexcept
-  {
-    auto result = handle_;
-    handle_ = {};
-    return result;
-  }
+/// The guard traits of the HMENU data type.
+struct Menu_guard_traits final {
+  /// An alias of the handle type.
+  using Handle = HMENU;
 
-  HMENU handle() const noexcept
+  /// @returns The value of an empty guard.
+  static Handle sentinel() noexcept
   {
-    return handle_;
+    return NULL;
   }
 
-  explicit operator bool() const noexcept
+  /// @returns `true` on success.
+  static bool destroy(const Handle handle) noexcept
   {
-    return static_cast<bool>(handle());
+    return DestroyMenu(handle);
   }
-
-private:
-  HMENU handle_{};
 };
 
-inline void append_menu_item(const HMENU menu, const std::string_view text,
+/// A very thin wrapper around the HMENU data type.
+using Menu_guard = Basic_guard<Menu_guard_traits>;
+
+/**
+ * @brief Appends the menu item to the end of `menu`.
+ *
+ * @remarks No conversion or allocation happens on this path.
+ */
+inline void append_menu_item(const HMENU menu, const std::wstring& text,
   const UINT id, const UINT state, const HMENU submenu = {})
 {
-  auto mitem = utf8_to_utf16(text);
   MENUITEMINFOW mii{};
-  if constexpr (sizeof(decltype(mitem.size())) > sizeof(decltype(mii.cch))) {
-    if (mitem.size() > std::numeric_limits<decltype(mii.cch)>::max())
+  if constexpr (sizeof(decltype(text.size())) > sizeof(decltype(mii.cch))) {
+    if (text.size() > std::numeric_limits<decltype(mii.cch)>::max())
       throw std::runtime_error{"cannot append menu item"};
   }
   mii.cbSize = sizeof(MENUITEMINFOW);
@@ -97,9 +67,55 @@ inline void append_menu_item(const HMENU menu, const std::string_view text,
     mii.fMask |= MIIM_SUBMENU;
   mii.wID = id;
   mii.fState = state;
-  mii.dwTypeData = mitem.data();
-  mii.cch = static_cast<decltype(mii.cch)>(mitem.size());
-  InsertMenuItemW(menu, GetMenuItemCount(menu), true, &mii);
+  // InsertMenuItemW() doesn't modify the string on insertion.
+  mii.dwTypeData = const_cast<LPWSTR>(text.c_str());
+  mii.cch = static_cast<decltype(mii.cch)>(text.size());
+  // Position -1 with fByPosition set appends to the end of the menu, which
+  // spares the GetMenuItemCount() round-trip per insertion.
+  InsertMenuItemW(menu, static_cast<UINT>(-1), TRUE, &mii);
+}
+
+/// @overload
+inline void append_menu_item(const HMENU menu, const std::string_view text,
+  const UINT id, const UINT state, const HMENU submenu = {})
+{
+  append_menu_item(menu, utf8_to_utf16(text), id, state, submenu);
+}
+
+/// A menu item to be inserted by append_menu_items().
+struct Menu_item final {
+  std::wstring text;
+  UINT id{};
+  UINT state{};
+  HMENU submenu{};
+};
+
+/**
+ * @brief Appends the menu items to the end of `menu`.
+ *
+ * @details The MENUITEMINFOW structure is set up once and only the per-item
+ * fields are mutated between the InsertMenuItemW() calls.
+ */
+inline void append_menu_items(const HMENU menu,
+  const std::span<const Menu_item> items)
+{
+  MENUITEMINFOW mii{};
+  mii.cbSize = sizeof(MENUITEMINFOW);
+  for (const auto& item : items) {
+    if constexpr (sizeof(decltype(item.text.size())) > sizeof(decltype(mii.cch))) {
+      if (item.text.size() > std::numeric_limits<decltype(mii.cch)>::max())
+        throw std::runtime_error{"cannot append menu items"};
+    }
+    mii.fMask = MIIM_STRING | MIIM_STATE | MIIM_ID;
+    if ( (mii.hSubMenu = item.submenu))
+      mii.fMask |= MIIM_SUBMENU;
+    mii.wID = item.id;
+    mii.fState = item.state;
+    // InsertMenuItemW() doesn't modify the string on insertion.
+    mii.dwTypeData = const_cast<LPWSTR>(item.text.c_str());
+    mii.cch = static_cast<decltype(mii.cch)>(item.text.size());
+    InsertMenuItemW(menu, static_cast<UINT>(-1), TRUE, &mii);
+  }
 }
 
 } // namespace dmitigr::winbase
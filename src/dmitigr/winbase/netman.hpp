@@ -19,14 +19,15 @@
 #pragma once
 #pragma comment(lib, "netapi32")
 
-#include "../base/traits.hpp"
 #include "exceptions.hpp"
+#include "strconv.hpp"
 
+#include <initializer_list>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
-#include <vector>
 
 #include <Lm.h>
 
@@ -34,20 +35,40 @@ namespace dmitigr::winbase::netman {
 
 namespace detail {
 
-inline std::vector<LOCALGROUP_MEMBERS_INFO_0> to_vector_lgmi0(
-  const std::vector<PSID>& members)
+/// The information level which corresponds to the structure of type `T`.
+template<class T> inline constexpr DWORD wksta_info_level_v{};
+template<> inline constexpr DWORD wksta_info_level_v<WKSTA_INFO_100>{100};
+template<> inline constexpr DWORD wksta_info_level_v<WKSTA_INFO_101>{101};
+template<> inline constexpr DWORD wksta_info_level_v<WKSTA_INFO_102>{102};
+
+/**
+ * @returns `members` viewed as an array of member info structures of level 0.
+ *
+ * @remarks LOCALGROUP_MEMBERS_INFO_0 holds nothing but a PSID, so the view
+ * is just a pointer cast - no per-call vector of wrappers.
+ */
+inline std::span<const LOCALGROUP_MEMBERS_INFO_0> as_lgmi0(
+  const std::span<const PSID> members) noexcept
 {
-  std::vector<LOCALGROUP_MEMBERS_INFO_0> result;
-  result.reserve(members.size());
-  for (const auto psid : members)
-    result.emplace_back(psid);
-  return result;
+  static_assert(sizeof(LOCALGROUP_MEMBERS_INFO_0) == sizeof(PSID));
+  static_assert(std::is_standard_layout_v<LOCALGROUP_MEMBERS_INFO_0>);
+  return {reinterpret_cast<const LOCALGROUP_MEMBERS_INFO_0*>(members.data()),
+    members.size()};
 }
 
 } // namespace detail
 
+/// A deleter of the buffers allocated by the Net API.
+struct Net_api_buffer_deleter final {
+  void operator()(LPVOID const buffer) const noexcept
+  {
+    NetApiBufferFree(buffer);
+  }
+};
+
+/// @remarks The stateless deleter keeps Info pointer-sized and inlinable.
 template<class T>
-using Info = std::unique_ptr<T, NET_API_STATUS(*)(LPVOID)>;
+using Info = std::unique_ptr<T, Net_api_buffer_deleter>;
 
 // -----------------------------------------------------------------------------
 
@@ -55,22 +76,13 @@ template<class T>
 Info<T> workstation_info(const LMSTR server_name = {})
 {
   using D = std::decay_t<T>;
-  constexpr DWORD level = []
-  {
-    if constexpr (std::is_same_v<D, WKSTA_INFO_100>) {
-      return 100;
-    } else if constexpr (std::is_same_v<D, WKSTA_INFO_101>) {
-      return 101;
-    } else if constexpr (std::is_same_v<D, WKSTA_INFO_102>) {
-      return 102;
-    } else
-      static_assert(false_value<D>);
-  }();
+  constexpr DWORD level{detail::wksta_info_level_v<D>};
+  static_assert(level, "unsupported workstation information structure");
 
   LPBYTE buf{};
   if (const auto e = NetWkstaGetInfo(server_name, level, &buf); e != NERR_Success)
     throw Sys_exception{e, "cannot get workstation network information"};
-  return Info<T>{reinterpret_cast<D*>(buf), &NetApiBufferFree};
+  return Info<T>{reinterpret_cast<D*>(buf)};
 }
 
 // -----------------------------------------------------------------------------
@@ -79,18 +91,17 @@ template<Throw_modifier Tm = throw_all>
 Info<LOCALGROUP_INFO_1> local_group_info_1(const std::wstring& group_name,
   const std::wstring& server_name = {})
 {
-  const LPCWSTR server{!server_name.empty() ? server_name.c_str() : nullptr};
+  const LPCWSTR server{c_str_or_null(server_name)};
   LPBYTE buf{};
   const auto e = NetLocalGroupGetInfo(server, group_name.c_str(), 1, &buf);
   if (e != NERR_Success) {
     if constexpr (Tm == no_throw_if_not_found) {
       if (e == NERR_GroupNotFound)
-        return {nullptr, nullptr};
+        return {};
     }
     throw Sys_exception{e, "cannot get local group info of level 1"};
   }
-  return Info<LOCALGROUP_INFO_1>{
-    reinterpret_cast<LOCALGROUP_INFO_1*>(buf), &NetApiBufferFree};
+  return Info<LOCALGROUP_INFO_1>{reinterpret_cast<LOCALGROUP_INFO_1*>(buf)};
 }
 
 template<typename ... Types>
@@ -101,50 +112,80 @@ inline auto local_group_info_1_if_exists(Types&& ... args)
 
 // -----------------------------------------------------------------------------
 
+/**
+ * @brief Adds `members` to the local group `group_name`.
+ *
+ * @remarks The whole span goes to the Net API in a single call; prefer it
+ * over adding members one at a time, which pays the RPC round-trip per
+ * member.
+ */
 inline void local_group_add_members(const std::wstring& group_name,
-  std::vector<LOCALGROUP_MEMBERS_INFO_0> members,
+  const std::span<const LOCALGROUP_MEMBERS_INFO_0> members,
   const std::wstring& server_name = {})
 {
-  const LPCWSTR server{!server_name.empty() ? server_name.c_str() : nullptr};
+  const LPCWSTR server{c_str_or_null(server_name)};
 
+  // NetLocalGroupAddMembers() doesn't modify the buffer.
   const auto err = NetLocalGroupAddMembers(server, group_name.c_str(),
-    0, reinterpret_cast<LPBYTE>(members.data()), static_cast<DWORD>(members.size()));
+    0, reinterpret_cast<LPBYTE>(
+      const_cast<LOCALGROUP_MEMBERS_INFO_0*>(members.data())),
+    static_cast<DWORD>(members.size()));
   if (err != NERR_Success)
     throw Sys_exception{err, "cannot add group members"};
 }
 
 inline void local_group_add_members(const std::wstring& group_name,
-  const std::vector<PSID>& members,
+  const std::span<const PSID> members,
+  const std::wstring& server_name = {})
+{
+  local_group_add_members(group_name, detail::as_lgmi0(members), server_name);
+}
+
+inline void local_group_add_members(const std::wstring& group_name,
+  const std::initializer_list<PSID> members,
   const std::wstring& server_name = {})
 {
-  std::vector<LOCALGROUP_MEMBERS_INFO_0> mmbrs;
-  mmbrs.reserve(members.size());
-  for (const auto psid : members)
-    mmbrs.emplace_back(psid);
-  local_group_add_members(group_name, detail::to_vector_lgmi0(members),
-    server_name);
+  local_group_add_members(group_name,
+    std::span<const PSID>{members.begin(), members.size()}, server_name);
 }
 
 // -----------------------------------------------------------------------------
 
+/**
+ * @brief Removes `members` from the local group `group_name`.
+ *
+ * @remarks The whole span goes to the Net API in a single call; prefer it
+ * over removing members one at a time, which pays the RPC round-trip per
+ * member.
+ */
 inline void local_group_del_members(const std::wstring& group_name,
-  std::vector<LOCALGROUP_MEMBERS_INFO_0> members,
+  const std::span<const LOCALGROUP_MEMBERS_INFO_0> members,
   const std::wstring& server_name = {})
 {
-  const LPCWSTR server{!server_name.empty() ? server_name.c_str() : nullptr};
+  const LPCWSTR server{c_str_or_null(server_name)};
 
+  // NetLocalGroupDelMembers() doesn't modify the buffer.
   const auto err = NetLocalGroupDelMembers(server, group_name.c_str(),
-    0, reinterpret_cast<LPBYTE>(members.data()), static_cast<DWORD>(members.size()));
+    0, reinterpret_cast<LPBYTE>(
+      const_cast<LOCALGROUP_MEMBERS_INFO_0*>(members.data())),
+    static_cast<DWORD>(members.size()));
   if (err != NERR_Success)
     throw Sys_exception{err, "cannot remove group members"};
 }
 
 inline void local_group_del_members(const std::wstring& group_name,
-  const std::vector<PSID>& members,
+  const std::span<const PSID> members,
+  const std::wstring& server_name = {})
+{
+  local_group_del_members(group_name, detail::as_lgmi0(members), server_name);
+}
+
+inline void local_group_del_members(const std::wstring& group_name,
+  const std::initializer_list<PSID> members,
   const std::wstring& server_name = {})
 {
-  local_group_del_members(group_name, detail::to_vector_lgmi0(members),
-    server_name);
+  local_group_del_members(group_name,
+    std::span<const PSID>{members.begin(), members.size()}, server_name);
 }
 
 } // namespace dmitigr::winbase::netman
@@ -23,10 +23,13 @@
 #include "windows.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -39,9 +42,13 @@ class Process_info final : private Noncopy {
 public:
   ~Process_info()
   {
-    CloseHandle(info_.hThread);
+    // CloseHandle(INVALID_HANDLE_VALUE) is a wasted kernel transition paid
+    // by every default-constructed or moved-from instance.
+    if (info_.hThread != INVALID_HANDLE_VALUE)
+      CloseHandle(info_.hThread);
     info_.hThread = INVALID_HANDLE_VALUE;
-    CloseHandle(info_.hProcess);
+    if (info_.hProcess != INVALID_HANDLE_VALUE)
+      CloseHandle(info_.hProcess);
     info_.hProcess = INVALID_HANDLE_VALUE;
   }
 
@@ -57,8 +64,11 @@ public:
   }
 
   Process_info(Process_info&& rhs) noexcept
-    : info_{std::move(rhs.info_)}
-  {}
+    : info_{rhs.info_}
+  {
+    rhs.info_ = PROCESS_INFORMATION{INVALID_HANDLE_VALUE, INVALID_HANDLE_VALUE,
+      static_cast<DWORD>(-1), static_cast<DWORD>(-1)};
+  }
 
   Process_info& operator=(Process_info&& rhs) noexcept
   {
@@ -130,23 +140,38 @@ inline Handle_guard open_process_token(const HANDLE process_handle,
 /// @returns The fully qualified path for the file that contains the specified `module`.
 inline std::filesystem::path module_filename(const HMODULE module = {})
 {
-  constexpr const std::size_t sz_inc{259};
-  std::wstring result(sz_inc, 0);
+  // Nearly every module path fits MAX_PATH: query into a stack buffer
+  // first, so the common case allocates nothing but the result itself.
+  wchar_t stack[MAX_PATH];
+  const DWORD stack_size{GetModuleFileNameW(module, stack, MAX_PATH)};
+  if (!stack_size)
+    throw std::runtime_error{last_error_message()};
+  else if (stack_size < MAX_PATH) [[likely]]
+    return std::wstring_view{stack, stack_size};
+
+  // 32767 characters plus the terminating NUL is the Windows path limit.
+  constexpr const std::size_t max_size{32768};
+  std::size_t size{2 * MAX_PATH};
+  // The scratch is left uninitialized: GetModuleFileNameW() overwrites
+  // exactly the part the result is constructed from.
+  auto buf = std::make_unique_for_overwrite<wchar_t[]>(size);
   while (true) {
-    const DWORD result_size{GetModuleFileNameW(module,
-      result.data(), result.size())};
+    const DWORD result_size{GetModuleFileNameW(module, buf.get(),
+      static_cast<DWORD>(size))};
     const DWORD err{GetLastError()};
     if (err == ERROR_INSUFFICIENT_BUFFER) {
-      result.resize(result.size() + sz_inc);
+      if (size >= max_size)
+        throw std::runtime_error{system_message(err)};
+      // Doubling keeps the number of retries logarithmic in the path length.
+      size = std::min(size * 2, max_size);
+      buf = std::make_unique_for_overwrite<wchar_t[]>(size);
     } else if (!result_size) {
       throw std::runtime_error{system_message(err)};
-    } else if (result_size <= result.size()) {
-      result.resize(result_size);
-      break;
+    } else if (result_size <= size) {
+      return std::wstring_view{buf.get(), result_size};
     } else
       throw std::logic_error{"bug of GetModuleFileNameW()"};
   }
-  return result;
 }
 
 /**
@@ -157,21 +182,33 @@ inline std::filesystem::path module_filename(const HMODULE module = {})
 inline std::wstring query_full_process_image_name(const HANDLE process,
   const DWORD flags = 0)
 {
-  constexpr const std::size_t sz_inc{259};
-  std::wstring result(sz_inc, 0);
+  // Nearly every image path fits MAX_PATH: query into a stack buffer
+  // first, so the common case allocates nothing but the result itself.
+  wchar_t stack[MAX_PATH];
+  DWORD stack_size{MAX_PATH};
+  if (QueryFullProcessImageNameW(process, flags, stack, &stack_size)) [[likely]]
+    return std::wstring{stack, stack_size};
+  else if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+    throw std::runtime_error{last_error_message()};
+
+  // 32767 characters plus the terminating NUL is the Windows path limit.
+  constexpr const std::size_t max_size{32768};
+  std::size_t size{2 * MAX_PATH};
+  // The scratch is left uninitialized: QueryFullProcessImageNameW()
+  // overwrites exactly the part the result is constructed from.
+  auto buf = std::make_unique_for_overwrite<wchar_t[]>(size + 1);
   while (true) {
-    auto sz = static_cast<DWORD>(result.size() + 1);
-    if (!QueryFullProcessImageNameW(process, flags, result.data(), &sz)) {
-      if (const DWORD err{GetLastError()}; err == ERROR_INSUFFICIENT_BUFFER)
-        result.resize(result.size() + sz_inc);
-      else
+    auto sz = static_cast<DWORD>(size + 1);
+    if (!QueryFullProcessImageNameW(process, flags, buf.get(), &sz)) {
+      if (const DWORD err{GetLastError()}; err != ERROR_INSUFFICIENT_BUFFER ||
+        size >= max_size)
         throw std::runtime_error{system_message(err)};
-    } else {
-      result.resize(sz);
-      break;
-    }
+      // Doubling keeps the number of retries logarithmic in the path length.
+      size = std::min(size * 2, max_size);
+      buf = std::make_unique_for_overwrite<wchar_t[]>(size + 1);
+    } else
+      return std::wstring{buf.get(), sz};
   }
-  return result;
 }
 
 /// @overload
@@ -185,19 +222,29 @@ inline std::wstring query_full_process_image_name(const DWORD process_id,
 /// @returns A vector of PIDs of process objects in the system.
 inline std::vector<DWORD> enum_processes()
 {
-  constexpr const std::size_t sz_inc{512};
-  std::vector<DWORD> result(sz_inc, -1);
+  using Pid = DWORD;
+  /*
+   * The process count is fairly stable across a program run: remembering
+   * the last observed size lets steady-state polling (monitoring loops)
+   * allocate a sufficient buffer on the first call. The extra 128 entries
+   * of headroom keep a slowly growing process count from forcing a retry.
+   */
+  static std::atomic<std::size_t> last_size{1024};
+  std::vector<Pid> result(
+    last_size.load(std::memory_order_relaxed) + 128, -1);
   while (true) {
-    using Pid = decltype(result)::value_type;
     const auto result_size_in_bytes = static_cast<DWORD>(result.size()*sizeof(Pid));
     DWORD needed_sz{};
     if (!EnumProcesses(result.data(), result_size_in_bytes, &needed_sz))
       throw std::runtime_error{last_error_message()};
     else if (needed_sz < result_size_in_bytes) {
       result.resize(needed_sz / sizeof(Pid));
+      last_size.store(result.size(), std::memory_order_relaxed);
       break;
     } else
-      result.resize(result.size() + sz_inc);
+      // A full buffer may mean truncation; doubling keeps the number of
+      // retries logarithmic in the process count.
+      result.resize(result.size() * 2);
   }
   return result;
 }
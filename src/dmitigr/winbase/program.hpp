@@ -19,10 +19,13 @@
 #include "process.hpp"
 #include "processenv.hpp"
 #include "shell.hpp"
+#include "strconv.hpp"
 
 #include <filesystem>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace dmitigr::winbase {
 
@@ -33,23 +36,33 @@ public:
   Program() = delete;
 
   /// Initialize instance.
-  static void init(const std::vector<std::string>& argv)
+  static void init(std::vector<std::wstring> wargv)
   {
-    check_initialized(false);
-
-    if (argv.empty())
-      throw std::invalid_argument{"invalid argv"};
-
-    argv_ = argv;
-    path_ = module_filename();
+    std::vector<std::string> argv;
+    argv.reserve(wargv.size());
+    for (const auto& arg : wargv)
+      argv.push_back(utf16_to_utf8(arg));
+    init__(std::move(wargv), std::move(argv));
+  }
 
-    check_initialized(true);
+  /// @overload
+  static void init(std::vector<std::string> argv)
+  {
+    std::vector<std::wstring> wargv;
+    wargv.reserve(argv.size());
+    for (const auto& arg : argv)
+      wargv.push_back(utf8_to_utf16(arg));
+    init__(std::move(wargv), std::move(argv));
   }
 
   /// @overload
   static void init()
   {
-    init(shell::command_line_to_vector<std::string>(GetCommandLineW()));
+    // The command line cannot change within a process: tokenize it at most
+    // once, however many times init() is attempted.
+    static const auto wargv =
+      shell::command_line_to_vector<std::wstring>(GetCommandLineW());
+    init(wargv);
   }
 
   /// @overload
@@ -71,6 +84,13 @@ public:
     return argv_;
   }
 
+  /// @returns Command line in UTF-16.
+  static const std::vector<std::wstring>& wargv()
+  {
+    check_initialized(true);
+    return wargv_;
+  }
+
   /// @returns argv().
   static const std::vector<std::string>& command_line()
   {
@@ -86,8 +106,29 @@ public:
 
 private:
   static inline std::vector<std::string> argv_;
+  static inline std::vector<std::wstring> wargv_;
   static inline std::filesystem::path path_;
 
+  /*
+   * The command line is kept in both encodings - the wide form the Win32
+   * consumers need and the narrow form of argv() - converted exactly once
+   * here. Whichever form the caller materialized is moved in, not copied.
+   */
+  static void init__(std::vector<std::wstring>&& wargv,
+    std::vector<std::string>&& argv)
+  {
+    check_initialized(false);
+
+    if (argv.empty())
+      throw std::invalid_argument{"invalid argv"};
+
+    argv_ = std::move(argv);
+    wargv_ = std::move(wargv);
+    path_ = module_filename();
+
+    check_initialized(true);
+  }
+
   static void check_initialized(const bool is_initialized)
   {
     const char* const msg = is_initialized ?
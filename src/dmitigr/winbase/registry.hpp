@@ -16,17 +16,26 @@
 
 #pragma once
 #pragma comment(lib, "advapi32")
+#pragma comment(lib, "ktmw32")
 
-#include "../base/assert.hpp"
 #include "../base/noncopymove.hpp"
 #include "../base/traits.hpp"
 #include "exceptions.hpp"
 #include "hguard.hpp"
+#include "strconv.hpp"
 
+#include <cstring>
+#include <cwchar>
+#include <memory>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
+#include <variant>
+#include <vector>
+
+#include <ktmw32.h>
 
 namespace dmitigr::winbase::registry {
 
@@ -83,11 +92,15 @@ public:
   /// @returns The error code.
   LSTATUS close() noexcept
   {
-    LSTATUS result{ERROR_SUCCESS};
-    if (handle_ != NULL) {
-      if ( (result = RegCloseKey(handle_)) != ERROR_SUCCESS)
-        handle_ = NULL;
-    }
+    if (handle_ == NULL)
+      return ERROR_SUCCESS;
+    const auto result = RegCloseKey(handle_);
+    /*
+     * Cleared unconditionally: the handle is dead after RegCloseKey()
+     * whatever the status, and keeping it would make the destructor
+     * close it a second time.
+     */
+    handle_ = NULL;
     return result;
   }
 
@@ -95,6 +108,51 @@ private:
   HKEY handle_{NULL};
 };
 
+/**
+ * @brief A Kernel Transaction Manager transaction.
+ *
+ * @details Groups several registry operations into a single atomic unit:
+ * pass the instance to the transacted functions (create_key_transacted(),
+ * remove_key_transacted()) and call commit() when done. Besides atomicity,
+ * batching the operations under one transaction saves per-operation hive
+ * log flushes.
+ *
+ * @remarks A transaction destroyed without commit() is rolled back by the
+ * kernel.
+ */
+class Transaction final : private Noncopy {
+public:
+  /// The constructor.
+  Transaction()
+    : handle_{CreateTransaction(nullptr, nullptr, 0, 0, 0, 0, nullptr)}
+  {
+    if (!handle_)
+      throw Sys_exception{"cannot create kernel transaction"};
+  }
+
+  /// @returns The transaction handle.
+  HANDLE handle() const noexcept
+  {
+    return handle_;
+  }
+
+  /// @returns The transaction handle.
+  operator HANDLE() const noexcept
+  {
+    return handle();
+  }
+
+  /// Commits the transaction.
+  void commit()
+  {
+    if (!CommitTransaction(handle_))
+      throw Sys_exception{"cannot commit kernel transaction"};
+  }
+
+private:
+  Handle_guard handle_;
+};
+
 inline Hkey_guard open_key(const HKEY key, LPCWSTR const subkey, const REGSAM mask,
   const DWORD options = 0)
 {
@@ -137,6 +195,50 @@ inline auto create_key(const HKEY key, const std::wstring& subkey,
   return create_key(key, subkey.c_str(), mask, secattrs, options);
 }
 
+/**
+ * @brief Creates (or opens) a key as a part of `transaction`.
+ *
+ * @returns A pair with created/opened key and disposition information.
+ *
+ * @remarks The returned key is bound to `transaction`: the operations
+ * performed on it become visible outside the transaction only after
+ * Transaction::commit().
+ */
+inline std::pair<Hkey_guard, DWORD>
+create_key_transacted(const HKEY key, LPCWSTR const subkey,
+  const REGSAM mask, const HANDLE transaction,
+  const LPSECURITY_ATTRIBUTES secattrs = {},
+  const DWORD options = 0)
+{
+  HKEY res_key{};
+  DWORD res_disp{};
+  const auto err = RegCreateKeyTransactedW(key,
+    subkey,
+    0,
+    NULL,
+    options,
+    mask,
+    secattrs,
+    &res_key,
+    &res_disp,
+    transaction,
+    nullptr);
+  if (err != ERROR_SUCCESS)
+    throw Sys_exception{static_cast<DWORD>(err),
+      "cannot create registry key transacted"};
+  return std::make_pair(Hkey_guard{res_key}, res_disp);
+}
+
+/// @overload
+inline auto create_key_transacted(const HKEY key, const std::wstring& subkey,
+  const REGSAM mask, const HANDLE transaction,
+  const LPSECURITY_ATTRIBUTES secattrs = {},
+  const DWORD options = 0)
+{
+  return create_key_transacted(key, subkey.c_str(), mask, transaction,
+    secattrs, options);
+}
+
 inline void set_value(const HKEY key, LPCWSTR const name, const DWORD type,
   const BYTE* const data, const DWORD size)
 {
@@ -152,7 +254,10 @@ void set_value(const HKEY key, LPCWSTR const name, const T& value)
     set_value(key, name, REG_DWORD, reinterpret_cast<const BYTE*>(&value), sizeof(T));
   } else if constexpr (std::is_same_v<T, LPCWSTR>) {
     const auto* const bytes = reinterpret_cast<const BYTE*>(value);
-    set_value(key, name, REG_SZ, bytes, sizeof(*value)*(lstrlenW(value) + 1));
+    // std::wcslen() is CRT code the compiler can inline and vectorize,
+    // unlike the imported lstrlenW().
+    set_value(key, name, REG_SZ, bytes,
+      static_cast<DWORD>(sizeof(*value)*(std::wcslen(value) + 1)));
   } else if constexpr (std::is_same_v<T, std::wstring>) {
     const auto* const bytes = reinterpret_cast<const BYTE*>(value.c_str());
     set_value(key, name, REG_SZ, bytes,
@@ -181,8 +286,8 @@ inline void remove_value(const HKEY key,
 inline void remove_value(const HKEY key, const std::wstring& subkey = {},
   const std::wstring& value_name = {})
 {
-  LPCWSTR subkey_str{!subkey.empty() ? subkey.c_str() : nullptr};
-  LPCWSTR value_name_str{!value_name.empty() ? value_name.c_str() : nullptr};
+  LPCWSTR subkey_str{c_str_or_null(subkey)};
+  LPCWSTR value_name_str{c_str_or_null(value_name)};
   remove_value(key, subkey_str, value_name_str);
 }
 
@@ -199,6 +304,29 @@ inline void remove_key(const HKEY key, const std::wstring& subkey)
   remove_key(key, subkey.c_str());
 }
 
+/**
+ * @brief Removes a key as a part of `transaction`.
+ *
+ * @remarks The key is actually removed upon Transaction::commit(); within
+ * the transaction it's already seen as deleted, so a parent key may be
+ * removed after its subkeys under the same transaction.
+ */
+inline void remove_key_transacted(const HKEY key, LPCWSTR const subkey,
+  const HANDLE transaction, const REGSAM mask = 0)
+{
+  if (const auto err = RegDeleteKeyTransactedW(key, subkey, mask, 0,
+      transaction, nullptr); err != ERROR_SUCCESS)
+    throw Sys_exception{static_cast<DWORD>(err),
+      "cannot remove registry key transacted"};
+}
+
+/// @overload
+inline void remove_key_transacted(const HKEY key, const std::wstring& subkey,
+  const HANDLE transaction, const REGSAM mask = 0)
+{
+  remove_key_transacted(key, subkey.c_str(), transaction, mask);
+}
+
 /**
  * @returns The number of bytes, including `2` extra terminating nulls,
  * required to store the requested string, or `0` if no such a string found.
@@ -260,23 +388,44 @@ std::optional<T> value(const HKEY key, LPCWSTR const subkey, LPCWSTR const name)
   } else if constexpr (is_same_v<Type, std::string> || is_same_v<Type, std::wstring>) {
     constexpr const auto char_size = sizeof(typename Type::value_type);
     static_assert(char_size <= sizeof(wchar_t));
-    auto buf_size = required_buffer_size(key, subkey, name);
-    if (!buf_size)
-      return std::nullopt;
-    else if (buf_size % char_size)
-      throw std::runtime_error{"cannot get string (REG_SZ) from registry:"
-        " incompatible destination string type"};
-    Type result(buf_size/char_size - sizeof(wchar_t)/char_size, 0);
-    const auto err = RegGetValueW(key,
+    // Strips the terminating null RegGetValueW() stores after the data.
+    static const auto make_result = [](const void* const data, const DWORD size)
+    {
+      if (size % char_size || size < sizeof(wchar_t))
+        throw std::runtime_error{"cannot get string (REG_SZ) from registry:"
+          " incompatible destination string type"};
+      return Type{static_cast<const typename Type::value_type*>(data),
+        size/char_size - sizeof(wchar_t)/char_size};
+    };
+    /*
+     * One call with a stack buffer first: the separate size probe is a
+     * registry traversal and kernel transition of its own, previously
+     * paid on every lookup.
+     */
+    wchar_t stack[256];
+    DWORD buf_size{sizeof(stack)};
+    auto err = RegGetValueW(key,
       subkey,
       name,
       RRF_RT_REG_SZ,
       NULL,
-      result.data(),
+      stack,
       &buf_size);
-    DMITIGR_ASSERT(buf_size == result.size()*char_size ||
-      buf_size == (result.size() + 1)*char_size);
-    return result_or_throw(std::move(result), err);
+    if (err == ERROR_SUCCESS)
+      return make_result(stack, buf_size);
+    else if (err == ERROR_MORE_DATA) {
+      const auto buf = std::make_unique_for_overwrite<BYTE[]>(buf_size);
+      err = RegGetValueW(key,
+        subkey,
+        name,
+        RRF_RT_REG_SZ,
+        NULL,
+        buf.get(),
+        &buf_size);
+      if (err == ERROR_SUCCESS)
+        return make_result(buf.get(), buf_size);
+    }
+    return result_or_throw(Type{}, err);
   } else
     static_assert(false_value<T>, "unsupported type specified");
 }
@@ -289,6 +438,62 @@ std::optional<T> value(const HKEY key, const std::wstring& subkey,
   return value<T>(key, subkey.c_str(), name.c_str());
 }
 
+/**
+ * @brief Reads all the values of `key` of types REG_DWORD and REG_SZ.
+ *
+ * @returns The vector of (name, value) pairs.
+ *
+ * @details One RegQueryInfoKeyW() call sizes the shared name and data
+ * buffers and the result vector, then RegEnumValueW() walks the key
+ * sequentially reusing them, so reading a whole settings block costs no
+ * per-value size probe or allocation, unlike value<T>() in a loop.
+ *
+ * @remarks The values of other types are skipped.
+ */
+inline std::vector<std::pair<std::wstring, std::variant<DWORD, std::wstring>>>
+enum_values(const HKEY key)
+{
+  DWORD value_count{};
+  DWORD max_name_size{};
+  DWORD max_data_size{};
+  if (const auto err = RegQueryInfoKeyW(key, nullptr, nullptr, nullptr,
+      nullptr, nullptr, nullptr, &value_count, &max_name_size,
+      &max_data_size, nullptr, nullptr); err != ERROR_SUCCESS)
+    throw Sys_exception{static_cast<DWORD>(err),
+      "cannot query registry key information"};
+
+  std::vector<std::pair<std::wstring, std::variant<DWORD, std::wstring>>> result;
+  result.reserve(value_count);
+  std::wstring name(max_name_size, 0);
+  const auto data = std::make_unique_for_overwrite<BYTE[]>(max_data_size);
+  for (DWORD i{}; i < value_count; ++i) {
+    auto name_size = static_cast<DWORD>(name.size() + 1);
+    DWORD type{};
+    DWORD data_size{max_data_size};
+    const auto err = RegEnumValueW(key, i, name.data(), &name_size,
+      nullptr, &type, data.get(), &data_size);
+    if (err == ERROR_NO_MORE_ITEMS)
+      break;
+    else if (err != ERROR_SUCCESS)
+      throw Sys_exception{static_cast<DWORD>(err),
+        "cannot enumerate values of registry key"};
+    if (type == REG_DWORD && data_size == sizeof(DWORD)) {
+      DWORD value{};
+      std::memcpy(&value, data.get(), sizeof(value));
+      result.emplace_back(std::wstring{name.data(), name_size}, value);
+    } else if (type == REG_SZ) {
+      auto size = data_size / sizeof(wchar_t);
+      const auto* const chars = reinterpret_cast<const wchar_t*>(data.get());
+      // The stored data may or may not include the terminating null.
+      if (size && !chars[size - 1])
+        --size;
+      result.emplace_back(std::wstring{name.data(), name_size},
+        std::wstring{chars, size});
+    }
+  }
+  return result;
+}
+
 // -----------------------------------------------------------------------------
 
 inline void notify_change_key_value(const HKEY key,
@@ -19,14 +19,29 @@
 #include "windows.hpp"
 
 #include <string>
+#include <string_view>
 
 namespace dmitigr::winbase {
 
-inline std::wstring load_wstring(const UINT id, const HINSTANCE instance = {})
+/**
+ * @returns A view of the string resource `id`.
+ *
+ * @remarks The view points straight into the resource section of the
+ * module - no copy - and stays valid for as long as the module is loaded.
+ * The resource string is not null-terminated.
+ */
+inline std::wstring_view load_wstring_view(const UINT id,
+  const HINSTANCE instance = {})
 {
   LPWSTR ptr{};
   const int r{LoadStringW(instance, id, reinterpret_cast<LPWSTR>(&ptr), 0)};
-  return std::wstring(ptr, r);
+  return std::wstring_view{ptr, static_cast<std::size_t>(r)};
+}
+
+/// @returns A copy of the string resource `id`.
+inline std::wstring load_wstring(const UINT id, const HINSTANCE instance = {})
+{
+  return std::wstring{load_wstring_view(id, instance)};
 }
 
 } // namespace dmitigr::winbase
@@ -26,7 +26,9 @@
 
 #include <filesystem>
 #include <stdexcept>
+#include <span>
 #include <string>
+#include <unordered_map>
 
 #include <knownfolders.h>
 #include <propkey.h>
@@ -39,94 +41,276 @@ namespace dmitigr::winbase::rt::ui::notifications {
 namespace base = ABI::Windows::UI::Notifications;
 namespace wrl = Microsoft::WRL;
 
-inline std::filesystem::path shortcut_path(
-  const std::wstring& app_name,
-  const std::filesystem::path& subpath,
-  const bool is_for_current_user)
+namespace detail {
+
+/**
+ * @returns The activation factory of ToastNotificationManager.
+ *
+ * @remarks The factory is process-wide and resolving it walks the WinRT
+ * activation registry, so it's cached on first use. The cached reference
+ * is deliberately never released: a static destructor could otherwise run
+ * after RoUninitialize().
+ */
+inline base::IToastNotificationManagerStatics* toast_manager()
 {
-  const auto folder = is_for_current_user ? FOLDERID_Programs :
-    FOLDERID_CommonPrograms;
-  auto result = shell::known_folder_path(folder);
-  if (!subpath.empty())
-    result /= subpath;
-  result /= app_name;
-  return result.replace_extension("lnk");
+  static base::IToastNotificationManagerStatics* const result =
+    []
+    {
+      wrl::ComPtr<base::IToastNotificationManagerStatics> factory;
+      if (FAILED(Windows::Foundation::GetActivationFactory(
+            wrl::Wrappers::HStringReference(
+              RuntimeClass_Windows_UI_Notifications_ToastNotificationManager).Get(),
+            &factory)))
+        throw std::runtime_error{"cannot retrieve activation factory for"
+          " RuntimeClass_Windows_UI_Notifications_ToastNotificationManager"};
+      return factory.Detach();
+    }();
+  return result;
 }
 
-inline void create_shortcut(const std::filesystem::path& shortcut,
+/**
+ * @returns The activation factory of ToastNotification.
+ *
+ * @remarks See toast_manager() for the caching rationale.
+ */
+inline base::IToastNotificationFactory* toast_factory()
+{
+  static base::IToastNotificationFactory* const result =
+    []
+    {
+      wrl::ComPtr<base::IToastNotificationFactory> factory;
+      if (FAILED(Windows::Foundation::GetActivationFactory(
+            wrl::Wrappers::HStringReference(
+              RuntimeClass_Windows_UI_Notifications_ToastNotification).Get(),
+            &factory)))
+        throw std::runtime_error{"cannot get toast notification factory"};
+      return factory.Detach();
+    }();
+  return result;
+}
+
+/**
+ * @returns The toast notifier of the application `app_name`.
+ *
+ * @remarks CreateToastNotifierWithId() is a cross-apartment COM call, so
+ * the notifiers are cached per AUMID. IToastNotifier is apartment-affine,
+ * hence the cache is per-thread rather than process-wide.
+ */
+inline base::IToastNotifier* notifier(
+  base::IToastNotificationManagerStatics& manager,
+  const std::wstring& app_name)
+{
+  thread_local std::unordered_map<std::wstring,
+    wrl::ComPtr<base::IToastNotifier>> cache;
+  auto& result = cache[app_name];
+  if (!result) {
+    // The two-argument HStringReference skips the length scan of the AUMID.
+    if (FAILED(manager.CreateToastNotifierWithId(
+      wrl::Wrappers::HStringReference(app_name.c_str(),
+        static_cast<UINT32>(app_name.size())).Get(),
+      &result))) [[unlikely]]
+      throw std::runtime_error{"cannot create toast notifier"};
+  }
+  return result.Get();
+}
+
+/**
+ * @returns `true` if `shortcut` exists and already points to `exepath`
+ * with the AppUserModelID `app_name`.
+ *
+ * @remarks Any failure to read the shortcut reports a mismatch, so the
+ * caller just falls through to the rewrite path.
+ */
+inline bool shortcut_matches(const std::filesystem::path& shortcut,
+  const std::filesystem::path& exepath,
+  const std::wstring& app_name)
+{
+  wrl::ComPtr<IShellLink> shell_link;
+  if (FAILED(CoCreateInstance(CLSID_ShellLink, nullptr,
+        CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&shell_link))))
+    return false;
+
+  wrl::ComPtr<IPersistFile> persist_file;
+  if (FAILED(shell_link.As(&persist_file)))
+    return false;
+  if (FAILED(persist_file->Load(shortcut.c_str(), STGM_READ)))
+    return false;
+
+  wchar_t target[MAX_PATH];
+  if (FAILED(shell_link->GetPath(target, MAX_PATH, nullptr, 0)))
+    return false;
+  if (exepath.native() != target)
+    return false;
+
+  wrl::ComPtr<IPropertyStore> property_store;
+  if (FAILED(shell_link.As(&property_store)))
+    return false;
+  PROPVARIANT prop{};
+  if (FAILED(property_store->GetValue(PKEY_AppUserModel_ID, &prop)))
+    return false;
+  const bool result{prop.vt == VT_LPWSTR && prop.pwszVal &&
+    app_name == prop.pwszVal};
+  PropVariantClear(&prop);
+  return result;
+}
+
+/**
+ * @brief Fills `shell_link` and saves it as `shortcut`.
+ *
+ * @remarks Every field is overwritten, so the same IShellLink instance
+ * (with its IPropertyStore and IPersistFile views) can serve a whole
+ * batch of shortcuts.
+ */
+inline void save_shortcut(IShellLink& shell_link,
+  IPropertyStore& property_store, IPersistFile& persist_file,
+  const std::filesystem::path& shortcut,
   const std::filesystem::path& exepath,
   const std::wstring& app_name,
   REFCLSID activator)
 {
-  if (shortcut.empty())
+  if (shortcut.empty()) [[unlikely]]
     throw std::invalid_argument{"cannot create shortcut by using empty path"};
-  else if (app_name.empty())
+  else if (app_name.empty()) [[unlikely]]
     throw std::invalid_argument{"cannot create shortcut by using empty"
       " application name"};
 
-  wrl::ComPtr<IShellLink> shell_link;
-  if (FAILED(CoCreateInstance(CLSID_ShellLink, nullptr,
-        CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&shell_link))))
-    throw std::runtime_error{"cannot create instance of IShellLink"};
+  // path::native() is already a std::wstring on Windows - bind it rather
+  // than copying via path::wstring().
+  const std::wstring& wexepath = exepath.native();
+  if (FAILED(shell_link.SetPath(wexepath.c_str()))) [[unlikely]]
+    throw std::runtime_error{"cannot set path of IShellLink"};
 
   {
-    const auto wexepath = exepath.wstring();
-    if (FAILED(shell_link->SetPath(wexepath.c_str())))
-      throw std::runtime_error{"cannot set path of IShellLink"};
-  }
-
-  {
-    const auto wdir = exepath.parent_path().wstring();
-    if (FAILED(shell_link->SetWorkingDirectory(wdir.c_str())))
+    // The working directory is just the exe path up to the last separator:
+    // slicing it avoids constructing an intermediate parent_path().
+    const auto sep = wexepath.find_last_of(L"\\/");
+    const std::wstring wdir{wexepath, 0,
+      sep != std::wstring::npos ? sep : 0};
+    if (FAILED(shell_link.SetWorkingDirectory(wdir.c_str()))) [[unlikely]]
       throw std::runtime_error{"cannot set working directory of IShellLink"};
   }
 
-  wrl::ComPtr<IPropertyStore> property_store;
-  if (FAILED(shell_link.As(&property_store)))
-    throw std::runtime_error{"cannot represent IShellLink as IPropertyStore"};
-
   {
+    // Value-initialization zeroes the variant - no PropVariantClear() call
+    // (a no-op crossing a DLL boundary) is needed on a fresh PROPVARIANT.
     PROPVARIANT prop{};
-    PropVariantClear(&prop);
     prop.vt = VT_LPWSTR;
     prop.pwszVal = const_cast<PWSTR>(app_name.c_str());
-    if (FAILED(property_store->SetValue(PKEY_AppUserModel_ID, prop)))
+    if (FAILED(property_store.SetValue(PKEY_AppUserModel_ID, prop))) [[unlikely]]
       throw std::runtime_error{"cannot set PKEY_AppUserModel_ID"};
   }
 
   {
     PROPVARIANT prop{};
-    PropVariantClear(&prop);
     prop.vt = VT_CLSID;
     prop.puuid = const_cast<CLSID*>(&activator);
-    if (FAILED(property_store->SetValue(
-          PKEY_AppUserModel_ToastActivatorCLSID, prop)))
+    if (FAILED(property_store.SetValue(
+          PKEY_AppUserModel_ToastActivatorCLSID, prop))) [[unlikely]]
       throw std::runtime_error{"cannot set PKEY_AppUserModel_ToastActivatorCLSID"};
   }
 
-  if (FAILED(property_store->Commit()))
+  if (FAILED(property_store.Commit())) [[unlikely]]
     throw std::runtime_error{"cannot commit the changes of IPropertyStore"};
 
-  wrl::ComPtr<IPersistFile> persist_file;
-  if (FAILED(shell_link.As(&persist_file)))
-    throw std::runtime_error{"cannot represent IShellLink as IPersistFile"};
-
   {
-    const auto wpath = shortcut.wstring();
-    if (FAILED(persist_file->Save(wpath.c_str(), true)))
+    const std::wstring& wpath = shortcut.native();
+    if (FAILED(persist_file.Save(wpath.c_str(), true))) [[unlikely]]
       throw std::runtime_error{"cannot save shortcut to "+shortcut.string()};
   }
 }
 
+} // namespace detail
+
+inline std::filesystem::path shortcut_path(
+  const std::wstring& app_name,
+  const std::filesystem::path& subpath,
+  const bool is_for_current_user)
+{
+  const auto folder = is_for_current_user ? FOLDERID_Programs :
+    FOLDERID_CommonPrograms;
+  auto result = shell::known_folder_path(folder);
+  if (!subpath.empty())
+    result /= subpath;
+  result /= app_name;
+  return result.replace_extension("lnk");
+}
+
+inline void create_shortcut(const std::filesystem::path& shortcut,
+  const std::filesystem::path& exepath,
+  const std::wstring& app_name,
+  REFCLSID activator)
+{
+  wrl::ComPtr<IShellLink> shell_link;
+  if (FAILED(CoCreateInstance(CLSID_ShellLink, nullptr,
+        CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&shell_link)))) [[unlikely]]
+    throw std::runtime_error{"cannot create instance of IShellLink"};
+
+  wrl::ComPtr<IPropertyStore> property_store;
+  if (FAILED(shell_link.As(&property_store))) [[unlikely]]
+    throw std::runtime_error{"cannot represent IShellLink as IPropertyStore"};
+
+  wrl::ComPtr<IPersistFile> persist_file;
+  if (FAILED(shell_link.As(&persist_file))) [[unlikely]]
+    throw std::runtime_error{"cannot represent IShellLink as IPersistFile"};
+
+  detail::save_shortcut(*shell_link.Get(), *property_store.Get(),
+    *persist_file.Get(), shortcut, exepath, app_name, activator);
+}
+
+/// A shortcut specification for create_shortcuts().
+struct Shortcut_spec final {
+  std::filesystem::path shortcut;
+  std::filesystem::path exepath;
+  std::wstring app_name;
+  CLSID activator{};
+};
+
+/**
+ * @brief Creates a shortcut per specification of `specs`.
+ *
+ * @details A single IShellLink instance (with its IPropertyStore and
+ * IPersistFile views) serves the whole batch - every field is overwritten
+ * per item - so creating N shortcuts costs one CoCreateInstance() and two
+ * QueryInterface() calls instead of N of each.
+ */
+inline void create_shortcuts(const std::span<const Shortcut_spec> specs)
+{
+  if (specs.empty())
+    return;
+
+  wrl::ComPtr<IShellLink> shell_link;
+  if (FAILED(CoCreateInstance(CLSID_ShellLink, nullptr,
+        CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&shell_link)))) [[unlikely]]
+    throw std::runtime_error{"cannot create instance of IShellLink"};
+
+  wrl::ComPtr<IPropertyStore> property_store;
+  if (FAILED(shell_link.As(&property_store))) [[unlikely]]
+    throw std::runtime_error{"cannot represent IShellLink as IPropertyStore"};
+
+  wrl::ComPtr<IPersistFile> persist_file;
+  if (FAILED(shell_link.As(&persist_file))) [[unlikely]]
+    throw std::runtime_error{"cannot represent IShellLink as IPersistFile"};
+
+  for (const auto& spec : specs)
+    detail::save_shortcut(*shell_link.Get(), *property_store.Get(),
+      *persist_file.Get(), spec.shortcut, spec.exepath, spec.app_name,
+      spec.activator);
+}
+
 inline void unregister_activator(REFCLSID activator,
   const std::wstring& app_name,
   const std::filesystem::path& subpath,
   const bool is_for_current_user)
 {
-  using registry::remove_key;
   const auto root = is_for_current_user ? HKEY_CURRENT_USER : HKEY_LOCAL_MACHINE;
-  remove_key(root, com::server_registry_localserver32(activator));
-  remove_key(root, com::server_registry_root(activator));
+
+  // One transaction removes both keys atomically with a single hive flush.
+  registry::Transaction tx;
+  registry::remove_key_transacted(root,
+    com::server_registry_localserver32(activator), tx);
+  registry::remove_key_transacted(root,
+    com::server_registry_root(activator), tx);
+  tx.commit();
 
   remove(shortcut_path(app_name, subpath, is_for_current_user));
 }
@@ -138,14 +322,36 @@ inline void register_activator(REFCLSID activator,
   const bool is_for_current_user,
   const std::wstring& handle_arg = L"handle")
 {
-  create_shortcut(shortcut_path(app_name, subpath, is_for_current_user),
-    exepath, app_name, activator);
-
   const auto root = is_for_current_user ? HKEY_CURRENT_USER : HKEY_LOCAL_MACHINE;
-  const auto [key, disp] = registry::create_key(root,
-    com::server_registry_localserver32(activator), KEY_WRITE);
-  registry::set_value(key, L"", L"\""+exepath.wstring()+L"\" "
-    + handle_arg);
+  const auto spath = shortcut_path(app_name, subpath, is_for_current_user);
+  const auto localserver32 = com::server_registry_localserver32(activator);
+
+  // Build the command line in one preallocated string instead of a chain
+  // of operator+ temporaries.
+  const std::wstring& wexepath = exepath.native();
+  std::wstring cmd;
+  cmd.reserve(wexepath.size() + handle_arg.size() + 3);
+  cmd += L'"';
+  cmd += wexepath;
+  cmd += L"\" ";
+  cmd += handle_arg;
+
+  // Registration is typically re-run on every launch: when the existing
+  // shortcut and registry entry already match the desired state, a couple
+  // of read-only checks replace the file and hive rewrites.
+  if (registry::value<std::wstring>(root, localserver32, L"") == cmd &&
+    detail::shortcut_matches(spath, exepath, app_name))
+    return;
+
+  create_shortcut(spath, exepath, app_name, activator);
+
+  // One transaction makes the key creation and the value write atomic and
+  // batches them into a single hive flush.
+  registry::Transaction tx;
+  const auto [key, disp] = registry::create_key_transacted(root,
+    localserver32, KEY_WRITE, tx);
+  registry::set_value(key, L"", cmd);
+  tx.commit();
 }
 
 /**
@@ -160,43 +366,24 @@ inline void show_toast(
   const std::wstring& app_name,
   data::xml::dom::base::IXmlDocument& xml)
 {
-  if (app_name.empty())
+  if (app_name.empty()) [[unlikely]]
     throw std::invalid_argument{"cannot show toast notification:"
       " empty application name"};
 
-  wrl::ComPtr<base::IToastNotifier> notifier;
-  if (FAILED(manager.CreateToastNotifierWithId(
-    wrl::Wrappers::HStringReference(app_name.c_str()).Get(),
-    &notifier)))
-    throw std::runtime_error{"cannot create toast notifier"};
-
-  wrl::ComPtr<base::IToastNotificationFactory> factory;
-  if (FAILED(Windows::Foundation::GetActivationFactory(
-    wrl::Wrappers::HStringReference(
-      RuntimeClass_Windows_UI_Notifications_ToastNotification).Get(),
-    &factory)))
-    throw std::runtime_error{"cannot get toast notification factory"};
-
   wrl::ComPtr<base::IToastNotification> toast;
-  if (FAILED(factory->CreateToastNotification(&xml, &toast)))
+  if (FAILED(detail::toast_factory()->CreateToastNotification(&xml, &toast)))
+    [[unlikely]]
     throw std::runtime_error{"cannot create toast notification"};
-  if (FAILED(notifier->Show(toast.Get())))
+  if (FAILED(detail::notifier(manager, app_name)->Show(toast.Get())))
+    [[unlikely]]
     throw std::runtime_error{"cannot schedule toast notification"};
 }
 
 /// @overload
 inline void show_toast(const std::wstring& app_name, const std::wstring& toast)
 {
-  wrl::ComPtr<base::IToastNotificationManagerStatics> manager;
-  if (FAILED(Windows::Foundation::GetActivationFactory(
-        wrl::Wrappers::HStringReference(
-          RuntimeClass_Windows_UI_Notifications_ToastNotificationManager).Get(),
-        &manager)))
-    throw std::runtime_error{"cannot retrieve activation factory for"
-      " RuntimeClass_Windows_UI_Notifications_ToastNotificationManager"};
-
   const auto doc = data::xml::dom::create_xml_document_from_string(toast);
-  show_toast(*manager.Get(), app_name, *doc.Get());
+  show_toast(*detail::toast_manager(), app_name, *doc.Get());
 }
 
 } // dmitigr::winbase::rt::ui::notifications
@@ -19,7 +19,6 @@
 #pragma once
 #pragma comment(lib, "runtimeobject")
 
-#include <functional>
 #include <stdexcept>
 #include <utility>
 
@@ -29,11 +28,17 @@ namespace dmitigr::winbase::rt::wrl::module {
 
 namespace base = Microsoft::WRL;
 
-/// Registers COM objects to allow (other applications) connect to them.
-template<base::ModuleType Type>
-void register_com_objects(std::function<void()> callback)
+/**
+ * @brief Registers COM objects to allow (other applications) connect to them.
+ *
+ * @remarks The callback is forwarded as is: Module::Create() accepts any
+ * callable, so erasing it through std::function would only add a possible
+ * heap allocation and an indirect call at server startup.
+ */
+template<base::ModuleType Type, typename Callback>
+void register_com_objects(Callback&& callback)
 {
-  base::Module<Type>::Create(std::move(callback));
+  base::Module<Type>::Create(std::forward<Callback>(callback));
 
   // Prevent COM server shutdown after activating the notification.
   base::Module<Type>::GetModule().IncrementObjectCount();
@@ -61,9 +66,10 @@ public:
     } catch (...) {}
   }
 
-  Com_objects_registrator(std::function<void()> callback)
+  template<typename Callback>
+  Com_objects_registrator(Callback&& callback)
   {
-    register_com_objects<Type>(std::move(callback));
+    register_com_objects<Type>(std::forward<Callback>(callback));
   }
 };
 
@@ -18,13 +18,15 @@
 #pragma comment(lib, "advapi32")
 
 #include "exceptions.hpp"
+#include "strconv.hpp"
 #include "windows.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
+#include <memory>
 #include <string>
-#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -68,14 +70,15 @@ public:
   {
     constexpr const auto sub_auth_sz = sizeof...(sub_authorities);
     static_assert(sub_auth_sz <= 8);
-    std::tuple<PSID_IDENTIFIER_AUTHORITY, BYTE,
-      DWORD, DWORD, DWORD, DWORD, DWORD, DWORD, DWORD, DWORD, PSID*> args{};
-    std::get<0>(args) = &authority;
-    std::get<1>(args) = static_cast<BYTE>(sub_auth_sz);
-    fill_subs(args, std::make_index_sequence<sub_auth_sz>{},
-      std::forward<const DWORD>(sub_authorities)...);
-    std::get<10>(args) = &ptr_;
-    if (!std::apply(AllocateAndInitializeSid, args))
+    // A zero-filled tail array instead of a tuple materialized for
+    // std::apply(): the call is direct and the arguments stay in
+    // registers/shadow space.
+    DWORD subs[8]{};
+    std::size_t i{};
+    ((subs[i++] = sub_authorities), ...);
+    if (!AllocateAndInitializeSid(&authority, static_cast<BYTE>(sub_auth_sz),
+        subs[0], subs[1], subs[2], subs[3],
+        subs[4], subs[5], subs[6], subs[7], &ptr_))
       throw Sys_exception{"cannot create Sid instance"};
   }
 
@@ -86,14 +89,6 @@ public:
 
 private:
   PSID ptr_{};
-
-  template<class Tuple, std::size_t ... I, typename ... S>
-  void fill_subs(Tuple& args, std::index_sequence<I...> seq,
-    const S ... sub_authorities)
-  {
-    static_assert(sizeof...(sub_authorities) == seq.size());
-    ((std::get<I + 2>(args) = sub_authorities), ...);
-  }
 };
 
 class Token_info final {
@@ -115,9 +110,12 @@ public:
         throw Sys_exception{err, errmsg};
     }
 
-    buf_.resize(sz);
-    if (!GetTokenInformation(token, type, buf_.data(),
-        static_cast<DWORD>(buf_.size()), &sz))
+    // The buffer is left uninitialized: GetTokenInformation() overwrites
+    // it, so the zero-fill of vector::resize() would be pure waste for
+    // large token groups or DACLs.
+    buf_ = std::make_unique_for_overwrite<char[]>(sz);
+    size_ = sz;
+    if (!GetTokenInformation(token, type, buf_.get(), size_, &sz))
       throw Sys_exception{errmsg};
 
     type_ = type;
@@ -131,7 +129,7 @@ public:
   template<class T>
   const T& data() const noexcept
   {
-    return *reinterpret_cast<const T*>(buf_.data());
+    return *reinterpret_cast<const T*>(buf_.get());
   }
 
   template<class T>
@@ -142,7 +140,7 @@ public:
 
   const void* bytes() const noexcept
   {
-    return buf_.data();
+    return buf_.get();
   }
 
   void* bytes() noexcept
@@ -152,12 +150,13 @@ public:
 
   DWORD size() const noexcept
   {
-    return static_cast<DWORD>(buf_.size());
+    return size_;
   }
 
 private:
   TOKEN_INFORMATION_CLASS type_{};
-  std::vector<char> buf_;
+  std::unique_ptr<char[]> buf_;
+  DWORD size_{};
 };
 
 // -----------------------------------------------------------------------------
@@ -171,7 +170,7 @@ inline LUID lookup_privilege_value(const std::wstring& privilege_name,
 {
   LUID result{};
   if (!LookupPrivilegeValueW(
-      system_name.empty() ? nullptr : system_name.c_str(),
+      c_str_or_null(system_name),
       privilege_name.c_str(), &result))
     throw Sys_exception{"cannot lookup privilege value"};
   return result;
@@ -184,25 +183,35 @@ inline LUID lookup_privilege_value(const std::wstring& privilege_name,
 inline std::wstring lookup_privilege_name(LUID luid,
   const std::wstring& system_name = {})
 {
-  DWORD sz{64 + 1};
+  /*
+   * Real privilege names are well under 128 characters: a stack buffer
+   * serves virtually every call without a heap-allocated scratch. Note
+   * the size convention of LookupPrivilegeNameW(): on success it excludes
+   * the terminating null, on ERROR_INSUFFICIENT_BUFFER it includes it.
+   */
+  wchar_t stack[128];
+  DWORD sz{128};
+  if (LookupPrivilegeNameW(c_str_or_null(system_name),
+      &luid, stack, &sz)) [[likely]]
+    return std::wstring{stack, sz};
+  else if (const DWORD err{GetLastError()}; err != ERROR_INSUFFICIENT_BUFFER)
+    throw Sys_exception{err, "cannot lookup privilege name"};
+
   std::wstring result(sz - 1, 0);
-  while (true) {
-    if (!LookupPrivilegeNameW(
-        system_name.empty() ? nullptr : system_name.c_str(),
-        &luid, result.data(), &sz)) {
-      if (const DWORD err{GetLastError()}; err == ERROR_INSUFFICIENT_BUFFER)
-        result.resize(sz - 1);
-      else
-        throw Sys_exception{err, "cannot lookup privilege name"};
-    } else {
-      result.resize(sz);
-      break;
-    }
-  }
+  if (!LookupPrivilegeNameW(c_str_or_null(system_name),
+      &luid, result.data(), &sz))
+    throw Sys_exception{"cannot lookup privilege name"};
+  result.resize(sz);
   return result;
 }
 
-/// A token privileges.
+/**
+ * @brief A token privileges.
+ *
+ * @details A few privileges are adjusted at a time in practice, so up to
+ * max_inline_count_ of them are stored right in the instance and the heap
+ * is involved only beyond that.
+ */
 class Token_privileges final {
 public:
   Token_privileges()
@@ -210,14 +219,25 @@ public:
   {}
 
   explicit Token_privileges(const DWORD count)
-    : data_(required_data_size(count))
   {
-    data()->PrivilegeCount = count;
+    resize(count);
   }
 
   void resize(const DWORD count)
   {
-    data_.resize(required_data_size(count));
+    const auto size = required_data_size(count);
+    if (size <= sizeof(inline_)) {
+      if (!heap_.empty()) {
+        std::memcpy(inline_, heap_.data(), size);
+        heap_.clear();
+        heap_.shrink_to_fit();
+      }
+    } else if (heap_.empty()) {
+      heap_.resize(size);
+      std::memcpy(heap_.data(), inline_, size_);
+    } else
+      heap_.resize(size);
+    size_ = size;
     data()->PrivilegeCount = count;
   }
 
@@ -228,7 +248,7 @@ public:
 
   DWORD size_in_bytes() const noexcept
   {
-    return static_cast<DWORD>(data_.size());
+    return static_cast<DWORD>(size_);
   }
 
   void set(const DWORD index, const LUID luid, const DWORD attributes)
@@ -254,7 +274,8 @@ public:
 
   const TOKEN_PRIVILEGES* data() const noexcept
   {
-    return reinterpret_cast<const TOKEN_PRIVILEGES*>(data_.data());
+    return reinterpret_cast<const TOKEN_PRIVILEGES*>(
+      heap_.empty() ? inline_ : heap_.data());
   }
 
   TOKEN_PRIVILEGES* data() noexcept
@@ -264,7 +285,12 @@ public:
   }
 
 private:
-  std::vector<char> data_;
+  static constexpr std::size_t max_inline_count_{4};
+  alignas(TOKEN_PRIVILEGES) char inline_[
+    sizeof(TOKEN_PRIVILEGES::PrivilegeCount) +
+    sizeof(TOKEN_PRIVILEGES::Privileges) * max_inline_count_]{};
+  std::vector<char> heap_;
+  std::size_t size_{};
 
   static std::size_t required_data_size(const DWORD count)
   {
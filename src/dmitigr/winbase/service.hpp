@@ -24,6 +24,8 @@
 #include "windows.hpp"
 
 #include <algorithm>
+#include <array>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -127,22 +129,24 @@ public:
 
   explicit Service_config(const SC_HANDLE service)
   {
-    DWORD buf_size{};
-    QueryServiceConfigW(service, nullptr, buf_size, &buf_size);
-    if (!buf_size)
-      throw Sys_exception{"cannot determine buffer size to store all the"
-        " service configuration information"};
-
-    data_.resize(buf_size);
-    auto* const qsc = reinterpret_cast<QUERY_SERVICE_CONFIGW*>(data_.data());
-    if (!QueryServiceConfigW(service, qsc, buf_size, &buf_size))
+    /*
+     * The config data is capped at 8K bytes by the API: one call with a
+     * full-size buffer replaces the size-probe + fetch pair of LRPC
+     * round-trips to services.exe. The data must stay where the API wrote
+     * it - QUERY_SERVICE_CONFIGW contains pointers into the buffer - so
+     * it's queried straight into the block the instance keeps.
+     */
+    constexpr const DWORD size{8 * 1024};
+    data_ = std::make_unique_for_overwrite<char[]>(size);
+    auto* const qsc = reinterpret_cast<QUERY_SERVICE_CONFIGW*>(data_.get());
+    DWORD required_size{};
+    if (!QueryServiceConfigW(service, qsc, size, &required_size))
       throw Sys_exception{"cannot query service configuration information"};
   }
 
   const QUERY_SERVICE_CONFIGW* ptr() const noexcept
   {
-    return !data_.empty() ?
-      reinterpret_cast<const QUERY_SERVICE_CONFIGW*>(data_.data()) : nullptr;
+    return reinterpret_cast<const QUERY_SERVICE_CONFIGW*>(data_.get());
   }
 
   const QUERY_SERVICE_CONFIGW* operator->() const
@@ -160,21 +164,42 @@ public:
 
   explicit operator bool() const noexcept
   {
-    return !data_.empty();
+    return static_cast<bool>(data_);
   }
 
 private:
-  std::vector<char> data_;
+  std::unique_ptr<char[]> data_;
 };
 
-inline SERVICE_DELAYED_AUTO_START_INFO
-query_service_delayed_auto_start_info(const SC_HANDLE service)
+/**
+ * @brief Attempts to query the delayed auto start info into `result`.
+ *
+ * @returns `true` on success; on failure stores the error code into
+ * `error` if it's not null.
+ *
+ * @remarks Lets the callers that query many services in a loop reuse a
+ * single structure and handle failures without exceptions.
+ */
+inline bool try_query_service_delayed_auto_start_info(const SC_HANDLE service,
+  SERVICE_DELAYED_AUTO_START_INFO& result, DWORD* const error = nullptr) noexcept
 {
-  SERVICE_DELAYED_AUTO_START_INFO result{};
   DWORD required_size{};
   if (!QueryServiceConfig2W(service, SERVICE_CONFIG_DELAYED_AUTO_START_INFO,
-      reinterpret_cast<LPBYTE>(&result), sizeof(result), &required_size))
-    throw Sys_exception{"cannot query service delayed auto start info"};
+      reinterpret_cast<LPBYTE>(&result), sizeof(result), &required_size)) {
+    if (error)
+      *error = GetLastError();
+    return false;
+  }
+  return true;
+}
+
+[[nodiscard]] inline SERVICE_DELAYED_AUTO_START_INFO
+query_service_delayed_auto_start_info(const SC_HANDLE service)
+{
+  SERVICE_DELAYED_AUTO_START_INFO result{};
+  DWORD err{};
+  if (!try_query_service_delayed_auto_start_info(service, result, &err))
+    throw Sys_exception{err, "cannot query service delayed auto start info"};
   return result;
 }
 
@@ -197,6 +222,43 @@ inline Sc_handle open_manager(const DWORD desired_access,
     throw Sys_exception{"cannot open service manager"};
 }
 
+/**
+ * @returns The cached service control manager handle of the calling thread
+ * opened with `desired_access`.
+ *
+ * @details Opening the manager is an LRPC round-trip to services.exe;
+ * caching the handle per (thread, access) pair makes code that touches
+ * many services pay it once instead of per service. The cached handles
+ * are closed at thread exit.
+ *
+ * @remarks The returned handle is owned by the cache and must not be
+ * closed by the caller or shared with other threads. The cache holds a
+ * few access masks; requesting more distinct masks than it has slots
+ * evicts (closes) the oldest entry, so don't retain the returned handle
+ * across subsequent default_manager() calls.
+ */
+inline SC_HANDLE default_manager(const DWORD desired_access = SC_MANAGER_CONNECT)
+{
+  thread_local std::array<std::pair<DWORD, Sc_handle>, 4> cache;
+  thread_local std::size_t evict_index{};
+  for (auto& [access, handle] : cache) {
+    if (handle && access == desired_access)
+      return handle;
+  }
+  for (auto& [access, handle] : cache) {
+    if (!handle) {
+      handle = open_manager(desired_access);
+      access = desired_access;
+      return handle;
+    }
+  }
+  auto& [access, handle] = cache[evict_index];
+  evict_index = (evict_index + 1) % cache.size();
+  handle = open_manager(desired_access);
+  access = desired_access;
+  return handle;
+}
+
 inline Sc_handle open_service(const SC_HANDLE manager,
   const LPCWSTR service_name, const DWORD desired_access)
 {
@@ -206,14 +268,42 @@ inline Sc_handle open_service(const SC_HANDLE manager,
     throw Sys_exception{"cannot open service"};
 }
 
-inline SERVICE_STATUS_PROCESS
-query_service_status_process_info(const SC_HANDLE service)
+/// @overload Opens the service via default_manager().
+inline Sc_handle open_service(const LPCWSTR service_name,
+  const DWORD desired_access)
+{
+  return open_service(default_manager(), service_name, desired_access);
+}
+
+/**
+ * @brief Attempts to query the status process info into `result`.
+ *
+ * @returns `true` on success; on failure stores the error code into
+ * `error` if it's not null.
+ *
+ * @remarks Lets the callers that query many services in a loop reuse a
+ * single structure and handle failures without exceptions.
+ */
+inline bool try_query_service_status_process_info(const SC_HANDLE service,
+  SERVICE_STATUS_PROCESS& result, DWORD* const error = nullptr) noexcept
 {
-  SERVICE_STATUS_PROCESS ssp{};
   DWORD required_size{};
   if (!QueryServiceStatusEx(service, SC_STATUS_PROCESS_INFO,
-      reinterpret_cast<LPBYTE>(&ssp), sizeof(ssp), &required_size))
-    throw Sys_exception{"cannot query service status process info"};
+      reinterpret_cast<LPBYTE>(&result), sizeof(result), &required_size)) {
+    if (error)
+      *error = GetLastError();
+    return false;
+  }
+  return true;
+}
+
+[[nodiscard]] inline SERVICE_STATUS_PROCESS
+query_service_status_process_info(const SC_HANDLE service)
+{
+  SERVICE_STATUS_PROCESS ssp{};
+  DWORD err{};
+  if (!try_query_service_status_process_info(service, ssp, &err))
+    throw Sys_exception{err, "cannot query service status process info"};
   return ssp;
 }
 
@@ -26,6 +26,7 @@
 #include "strconv.hpp"
 
 #include <algorithm>
+#include <charconv>
 #include <filesystem>
 #include <iterator>
 #include <stdexcept>
@@ -43,9 +44,14 @@ inline std::filesystem::path known_folder_path(REFKNOWNFOLDERID rfid,
 {
   PWSTR path{};
   const HRESULT err{SHGetKnownFolderPath(rfid, flags, user, &path)};
-  if (err != S_OK)
-    throw std::runtime_error{"cannot get known folder path: error "+
-      std::to_string(err)};
+  if (err != S_OK) {
+    // std::to_chars keeps the heavy std::to_string machinery out of
+    // this inline throwing site.
+    char buf[16];
+    const auto [p, ec] = std::to_chars(buf, buf + sizeof(buf), err);
+    throw std::runtime_error{std::string{"cannot get known folder path: error "}
+      .append(buf, static_cast<std::size_t>(p - buf))};
+  }
   return com::Taskmem<WCHAR>{path}.value();
 }
 
@@ -54,26 +60,25 @@ std::vector<String> argc_argv_to_vector(const int argc, const Ch* const* argv)
 {
   using C = std::decay_t<Ch>;
   using S = std::decay_t<String>;
+  using std::is_same_v;
+  static_assert(is_same_v<S, std::string> || is_same_v<S, std::wstring>,
+    "unsupported type");
+  static_assert(is_same_v<C, std::string::value_type> ||
+    is_same_v<C, std::wstring::value_type>, "unsupported type");
+
   std::vector<String> result;
   result.reserve(argc);
-  for (int i{}; i < argc; ++i) {
-    using std::is_same_v;
-    if constexpr (is_same_v<S, std::string>) {
-      if constexpr (is_same_v<C, std::wstring::value_type>)
+  if constexpr (is_same_v<typename S::value_type, C>)
+    // No conversion needed: the strings are constructed straight from
+    // the pointer range, with no per-iteration dispatch.
+    result.assign(argv, argv + argc);
+  else {
+    for (int i{}; i < argc; ++i) {
+      if constexpr (is_same_v<S, std::string>)
         result.push_back(utf16_to_utf8(argv[i]));
-      else if constexpr (is_same_v<C, std::string::value_type>)
-        result.emplace_back(argv[i]);
       else
-        static_assert(false_value<C>, "unsupported type");
-    } else if constexpr (std::is_same_v<S, std::wstring>) {
-      if constexpr (is_same_v<C, std::string::value_type>)
         result.push_back(utf8_to_utf16(argv[i]));
-      else if constexpr (is_same_v<C, std::wstring::value_type>)
-        result.emplace_back(argv[i]);
-      else
-        static_assert(false_value<C>, "unsupported type");
-    } else
-      static_assert(false_value<S>, "unsupported type");
+    }
   }
   return result;
 }
@@ -21,6 +21,8 @@
 #include "windows.hpp"
 
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <stdexcept>
 #include <string>
@@ -28,7 +30,40 @@
 
 namespace dmitigr::winbase {
 
-/// @returns The result of conversion UTF-8 string to UTF-16 wide string.
+/// @returns `str.c_str()`, or `nullptr` if `str` is empty.
+inline LPCWSTR c_str_or_null(const std::wstring& str) noexcept
+{
+  return !str.empty() ? str.c_str() : nullptr;
+}
+
+namespace detail {
+
+/// @returns `true` if every byte of `str` is below 0x80.
+inline bool is_ascii(const std::string_view str) noexcept
+{
+  std::uint64_t acc{};
+  std::size_t i{};
+  for (; i + 8 <= str.size(); i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, str.data() + i, 8);
+    acc |= word;
+  }
+  for (; i < str.size(); ++i)
+    acc |= static_cast<unsigned char>(str[i]);
+  return !(acc & 0x8080808080808080ull);
+}
+
+} // namespace detail
+
+/**
+ * @returns The result of conversion UTF-8 string to UTF-16 wide string.
+ *
+ * @details An ASCII-only input (the dominant case for argv, paths and
+ * log strings) is widened directly, in one pass: no MultiByteToWideChar
+ * call at all. The scan tests eight bytes a word at a time. Widening is
+ * only valid when the source is UTF-8, so the fast path is gated on
+ * `code_page`.
+ */
 inline std::wstring utf8_to_utf16(const std::string_view utf8,
   const UINT code_page = CP_UTF8)
 {
@@ -43,6 +78,30 @@ inline std::wstring utf8_to_utf16(const std::string_view utf8,
   if (utf8.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
     throw_error();
 
+  if (code_page == CP_UTF8 && detail::is_ascii(utf8)) {
+    std::wstring result(utf8.size(), L'\0');
+    for (std::size_t i{}; i < utf8.size(); ++i)
+      result[i] = static_cast<wchar_t>(static_cast<unsigned char>(utf8[i]));
+    return result;
+  }
+
+  /*
+   * A UTF-8 byte never produces more than one UTF-16 code unit, so a
+   * buffer of utf8.size() units always suffices: one conversion call with
+   * worst-case sizing replaces the size-probe + convert pair. Other code
+   * pages have no such bound and keep the two-call pattern.
+   */
+  if (code_page == CP_UTF8) {
+    std::wstring result(utf8.size(), L'\0');
+    const int rs = MultiByteToWideChar(code_page, 0,
+      utf8.data(), static_cast<int>(utf8.size()),
+      result.data(), static_cast<int>(result.size()));
+    if (!rs)
+      throw_error();
+    result.resize(rs);
+    return result;
+  }
+
   const int result_size = MultiByteToWideChar(code_page, 0,
     utf8.data(), static_cast<int>(utf8.size()), nullptr, 0);
   if (!result_size)
@@ -61,7 +120,61 @@ inline std::wstring utf8_to_utf16(const std::string_view utf8,
   return result;
 }
 
-/// @returns The result of conversion UTF-16 wide-string to UTF-8 string.
+/**
+ * @returns The result of conversion UTF-8 string to UTF-16 wide string,
+ * rejecting an invalid input.
+ *
+ * @details Unlike utf8_to_utf16(), which quietly maps malformed
+ * sequences to U+FFFD, this function throws on them. Validation is
+ * fused into the conversion itself via `MB_ERR_INVALID_CHARS` - a
+ * single pass over the input, no separate pre-scan and no allocation
+ * for inputs whose very sizing is rejected. An all-ASCII input is
+ * valid by construction and takes the direct widening path.
+ */
+inline std::wstring utf8_to_utf16_validated(const std::string_view utf8)
+{
+  if (utf8.empty())
+    return std::wstring{};
+
+  static const auto throw_error = []
+  {
+    throw std::runtime_error{"cannot convert an invalid UTF-8 string"
+      " to an UTF-16 string"};
+  };
+
+  if (utf8.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+    throw_error();
+
+  if (detail::is_ascii(utf8)) {
+    std::wstring result(utf8.size(), L'\0');
+    for (std::size_t i{}; i < utf8.size(); ++i)
+      result[i] = static_cast<wchar_t>(static_cast<unsigned char>(utf8[i]));
+    return result;
+  }
+
+  // See utf8_to_utf16() on the worst-case sizing.
+  std::wstring result(utf8.size(), L'\0');
+  const int rs = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS,
+    utf8.data(), static_cast<int>(utf8.size()),
+    result.data(), static_cast<int>(result.size()));
+  if (!rs)
+    throw_error();
+  result.resize(rs);
+  return result;
+}
+
+/**
+ * @returns The result of conversion UTF-16 wide-string to UTF-8 string.
+ *
+ * @details The ASCII prefix of the input (all of it for system messages,
+ * registry paths and the like, which are the dominant case) is narrowed
+ * directly, in one pass, with none of the surrogate handling ASCII never
+ * needs; only the part from the first non-ASCII code unit onwards goes to
+ * WideCharToMultiByte, in a single call with a worst-case-sized buffer.
+ * The scan tests four code units a word at a time. Narrowing is only
+ * valid when the target is UTF-8 (some ANSI code pages don't contain
+ * ASCII), so the fast path is gated on `code_page`.
+ */
 inline std::string utf16_to_utf8(const std::wstring_view utf16,
   const UINT code_page = CP_UTF8)
 {
@@ -76,6 +189,53 @@ inline std::string utf16_to_utf8(const std::wstring_view utf16,
   if (utf16.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
     throw_error();
 
+  // The size of the leading run of code units below 0x80.
+  static const auto ascii_prefix_size = [](const std::wstring_view str) noexcept
+  {
+    static_assert(sizeof(wchar_t) == 2);
+    std::size_t i{};
+    for (; i + 4 <= str.size(); i += 4) {
+      std::uint64_t word;
+      std::memcpy(&word, str.data() + i, 8);
+      if (word & 0xff80ff80ff80ff80ull)
+        break;
+    }
+    for (; i < str.size(); ++i) {
+      if (str[i] >= 0x80)
+        break;
+    }
+    return i;
+  };
+
+  if (code_page == CP_UTF8) {
+    const auto prefix_size = ascii_prefix_size(utf16);
+    const auto tail = utf16.substr(prefix_size);
+    /*
+     * A UTF-16 code unit never produces more than 3 UTF-8 bytes (a
+     * surrogate pair - 2 units - produces 4), so 3 bytes per tail unit
+     * always suffice: one conversion call with worst-case sizing replaces
+     * the size-probe + convert pair. Other code pages have no such bound
+     * and keep the two-call pattern.
+     */
+    if (tail.size() <= (static_cast<std::size_t>(
+        std::numeric_limits<int>::max()) - prefix_size) / 3) {
+      std::string result(prefix_size + 3 * tail.size(), '\0');
+      for (std::size_t i{}; i < prefix_size; ++i)
+        result[i] = static_cast<char>(utf16[i]);
+      if (tail.empty())
+        return result;
+      const int rs = WideCharToMultiByte(code_page, 0,
+        tail.data(), static_cast<int>(tail.size()),
+        result.data() + prefix_size,
+        static_cast<int>(3 * tail.size()),
+        nullptr, nullptr);
+      if (!rs)
+        throw_error();
+      result.resize(prefix_size + rs);
+      return result;
+    }
+  }
+
   const int result_size = WideCharToMultiByte(code_page, 0,
     utf16.data(), static_cast<int>(utf16.size()), nullptr, 0, nullptr, nullptr);
   if (!result_size)
@@ -97,14 +257,27 @@ inline std::string utf16_to_utf8(const std::wstring_view utf16,
 
 inline void upper_first_letter(std::wstring& str)
 {
-  if (!str.empty())
-    CharUpperBuffW(str.data(), 1);
+  if (!str.empty()) {
+    // An ASCII first letter toggles its case bit in place; only a
+    // non-ASCII one enters the Win32 case-mapping engine.
+    if (const wchar_t c{str[0]}; c < 0x80)
+      str[0] = static_cast<wchar_t>(
+        c ^ ((static_cast<unsigned>(c - L'a') < 26u) << 5));
+    else
+      CharUpperBuffW(str.data(), 1);
+  }
 }
 
 inline void lower_first_letter(std::wstring& str)
 {
-  if (!str.empty())
-    CharLowerBuffW(str.data(), 1);
+  if (!str.empty()) {
+    // See upper_first_letter().
+    if (const wchar_t c{str[0]}; c < 0x80)
+      str[0] = static_cast<wchar_t>(
+        c ^ ((static_cast<unsigned>(c - L'A') < 26u) << 5));
+    else
+      CharLowerBuffW(str.data(), 1);
+  }
 }
 
 inline std::wstring&& upper_first_letter(std::wstring&& str)
@@ -21,6 +21,8 @@
 #include "hguard.hpp"
 
 #include <chrono>
+#include <span>
+#include <stdexcept>
 
 namespace dmitigr::winbase {
 
@@ -42,25 +44,81 @@ inline Handle_guard open_event(const DWORD desired_access,
   return Handle_guard{result};
 }
 
+/**
+ * @brief Attempts to set the event.
+ *
+ * @returns `ERROR_SUCCESS` on success, the error code otherwise.
+ *
+ * @remarks Being noexcept, keeps exception-handling machinery out of
+ * tight signalling loops; set_event() wraps it for the throwing callers.
+ */
+inline DWORD try_set_event(const HANDLE hdl) noexcept
+{
+  return SetEvent(hdl) ? ERROR_SUCCESS : GetLastError();
+}
+
 inline void set_event(const HANDLE hdl)
 {
-  if (!SetEvent(hdl))
-    throw Sys_exception{"cannot set event"};
+  if (const auto e = try_set_event(hdl))
+    throw Sys_exception{e, "cannot set event"};
 }
 
 /**
+ * @brief Attempts to wait for the object.
+ *
  * @param handle A handle to the object.
  * @param timeout A timeout interval. The value of `timeout.max()` denotes INFINITE.
+ *
+ * @returns The raw wait status, including `WAIT_FAILED`.
+ *
+ * @remarks See try_set_event() for the noexcept rationale.
  */
+inline DWORD try_wait_for_single_object(const HANDLE handle,
+  const std::chrono::milliseconds timeout =
+    std::chrono::milliseconds::max()) noexcept
+{
+  const DWORD timeout_native{
+    timeout == timeout.max() ? INFINITE : static_cast<DWORD>(timeout.count())};
+  return WaitForSingleObject(handle, timeout_native);
+}
+
+/// @overload Throws on `WAIT_FAILED`.
 inline DWORD wait_for_single_object(const HANDLE handle,
   const std::chrono::milliseconds timeout = std::chrono::milliseconds::max())
 {
-  using Ms = std::chrono::milliseconds;
+  const auto result = try_wait_for_single_object(handle, timeout);
+  if (result == WAIT_FAILED)
+    throw Sys_exception{"cannot wait for single object"};
+  return result;
+}
+
+/**
+ * @brief Waits for one or all of the objects.
+ *
+ * @param handles Handles to the objects. Must not be empty, nor exceed
+ * `MAXIMUM_WAIT_OBJECTS` elements.
+ * @param wait_all If `true`, waits for all the objects, otherwise - for any.
+ * @param timeout A timeout interval. The value of `timeout.max()` denotes INFINITE.
+ *
+ * @returns The raw wait status.
+ *
+ * @remarks One kernel transition covers the whole wait set, where a loop
+ * over wait_for_single_object() would cost a transition per handle.
+ */
+inline DWORD wait_for_multiple_objects(const std::span<const HANDLE> handles,
+  const bool wait_all,
+  const std::chrono::milliseconds timeout = std::chrono::milliseconds::max())
+{
+  if (handles.empty() || handles.size() > MAXIMUM_WAIT_OBJECTS)
+    throw std::invalid_argument{"cannot wait for multiple objects:"
+      " invalid handle count"};
   const DWORD timeout_native{
     timeout == timeout.max() ? INFINITE : static_cast<DWORD>(timeout.count())};
-  const auto result = WaitForSingleObject(handle, timeout_native);
+  const auto result = WaitForMultipleObjects(
+    static_cast<DWORD>(handles.size()), handles.data(),
+    wait_all, timeout_native);
   if (result == WAIT_FAILED)
-    throw Sys_exception{"cannot wait for single object"};
+    throw Sys_exception{"cannot wait for multiple objects"};
   return result;
 }
 
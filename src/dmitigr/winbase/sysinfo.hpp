@@ -21,42 +21,129 @@
 #include "error.hpp"
 #include "exceptions.hpp"
 
+#include <array>
+#include <charconv>
 #include <filesystem>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 
 namespace dmitigr::winbase {
 
-inline std::filesystem::path system_directory()
+namespace detail {
+
+/// The cache of computer names by type. See computer_name().
+struct Computer_name_cache final {
+  std::mutex mutex;
+  std::array<std::optional<std::wstring>, ComputerNameMax> values;
+};
+
+/// @returns The instance of the computer name cache.
+inline Computer_name_cache& computer_name_cache()
+{
+  static Computer_name_cache result;
+  return result;
+}
+
+/**
+ * @returns `what` with the decimal `type` appended.
+ *
+ * @remarks The integer is formatted on the stack with std::to_chars and
+ * the result is built with a single allocation, keeping the std::to_string
+ * machinery out of the inline throwing sites.
+ */
+inline std::string name_error_message(const std::string_view what,
+  const COMPUTER_NAME_FORMAT type)
+{
+  char buf[16];
+  const auto [p, ec] = std::to_chars(buf, buf + sizeof(buf),
+    static_cast<int>(type));
+  const auto buf_size = static_cast<std::size_t>(p - buf);
+  std::string result;
+  result.reserve(what.size() + buf_size);
+  result.append(what).append(buf, buf_size);
+  return result;
+}
+
+} // namespace detail
+
+/**
+ * @returns The system directory.
+ *
+ * @remarks The directory cannot change while the process runs, so it's
+ * queried once and cached.
+ */
+inline const std::filesystem::path& system_directory()
 {
-  std::wstring result;
-  const auto size_with_null = GetSystemDirectoryW(result.data(), result.size());
-  if (!size_with_null)
-    throw Sys_exception{"cannot get system directory"};
-  result.resize(size_with_null - 1);
-  const auto sz = GetSystemDirectoryW(result.data(), result.size() + 1);
-  if (!sz)
-    throw Sys_exception{"cannot get system directory"};
-  DMITIGR_ASSERT(sz == size_with_null - 1);
+  static const std::filesystem::path result = []
+  {
+    // The system directory fits in MAX_PATH, so a single call into a
+    // stack buffer suffices; the size-probe path remains as a fallback.
+    wchar_t buf[MAX_PATH + 1];
+    const auto sz = GetSystemDirectoryW(buf, MAX_PATH + 1);
+    if (!sz)
+      throw Sys_exception{"cannot get system directory"};
+    if (sz <= MAX_PATH)
+      return std::filesystem::path{buf, buf + sz};
+
+    std::wstring str(sz - 1, L'\0');
+    const auto sz2 = GetSystemDirectoryW(str.data(), str.size() + 1);
+    if (!sz2)
+      throw Sys_exception{"cannot get system directory"};
+    DMITIGR_ASSERT(sz2 == sz - 1);
+    return std::filesystem::path{std::move(str)};
+  }();
   return result;
 }
 
+/**
+ * @returns The computer name of the specified `type`.
+ *
+ * @remarks The name is queried once per type - two kernel transitions -
+ * and cached for the process lifetime; set_computer_name() drops the
+ * cached values.
+ */
 inline std::wstring computer_name(const COMPUTER_NAME_FORMAT type)
 {
+  auto& cache = detail::computer_name_cache();
+  {
+    const std::lock_guard lg{cache.mutex};
+    if (const auto& value = cache.values[type])
+      return *value;
+  }
+
   DWORD sz{};
   GetComputerNameExW(type, nullptr, &sz);
   if (const auto e = last_error(); e != ERROR_MORE_DATA)
-    throw Sys_exception{e, "cannot get required size of computer name of type "
-      +std::to_string(type)};
+    throw Sys_exception{e, detail::name_error_message(
+      "cannot get required size of computer name of type ", type)};
   std::wstring result(sz, L'\0');
   if (!GetComputerNameExW(type, result.data(), &sz))
-    throw Sys_exception{"cannot get computer name of type "+std::to_string(type)};
-  return result;
+    throw Sys_exception{detail::name_error_message(
+      "cannot get computer name of type ", type)};
+  result.resize(sz);
+
+  const std::lock_guard lg{cache.mutex};
+  auto& value = cache.values[type];
+  if (!value)
+    value = std::move(result);
+  return *value;
 }
 
 inline void set_computer_name(const COMPUTER_NAME_FORMAT type, const LPCWSTR value)
 {
   if (!SetComputerNameExW(type, value))
-    throw Sys_exception{"cannot set computer name of type "+std::to_string(type)};
+    throw Sys_exception{detail::name_error_message(
+      "cannot set computer name of type ", type)};
+
+  // The name types are interrelated (the DNS-derived ones change
+  // together), so the whole cache is dropped rather than one entry.
+  auto& cache = detail::computer_name_cache();
+  const std::lock_guard lg{cache.mutex};
+  for (auto& cached : cache.values)
+    cached.reset();
 }
 
 /// @overload
@@ -68,9 +155,11 @@ inline void set_computer_name(const COMPUTER_NAME_FORMAT type, const std::wstrin
 /**
  * @returns The string representation of a `value`.
  *
- * @remarks The `value` can be retrieved by calling GetSystemInfo().
+ * @remarks The `value` can be retrieved by calling GetSystemInfo(). The
+ * result views a string literal, so it's valid forever and costs no
+ * allocation (the function sits on logging paths).
  */
-inline std::string cpu_architecture_string(const WORD value)
+constexpr std::string_view cpu_architecture_string(const WORD value) noexcept
 {
   switch (value) {
   case PROCESSOR_ARCHITECTURE_AMD64:
@@ -16,146 +16,51 @@
 
 #pragma once
 
-#include "../base/noncopymove.hpp"
+#include "hguard.hpp"
 #include "windows.hpp"
 
-#include <algorithm>
-#include <utility>
-
 namespace dmitigr::winbase {
 
-/// A very thin wrapper around the HDESK data type.
-class Hdesk_guard final : private Noncopy {
-public:
-  /// The destructor.
-  ~Hdesk_guard()
-  {
-    close();
-  }
-
-  /// The constructor.
-  explicit Hdesk_guard(const HDESK handle = NULL) noexcept
-    : handle_{handle}
-  {}
+/// The guard traits of the HDESK data type.
+struct Hdesk_guard_traits final {
+  /// An alias of the handle type.
+  using Handle = HDESK;
 
-  /// The move constructor.
-  Hdesk_guard(Hdesk_guard&& rhs) noexcept
-    : handle_{rhs.handle_}
+  /// @returns The value of an empty guard.
+  static Handle sentinel() noexcept
   {
-    rhs.handle_ = NULL;
+    return NULL;
   }
 
-  /// The move assignment operator.
-  Hdesk_guard& operator=(Hdesk_guard&& rhs) noexcept
+  /// @returns `true` on success.
+  static bool destroy(const Handle handle) noexcept
   {
-    if (this != &rhs) {
-      Hdesk_guard tmp{std::move(rhs)};
-      swap(tmp);
-    }
-    return *this;
+    return CloseDesktop(handle);
   }
+};
 
-  /// The swap operation.
-  void swap(Hdesk_guard& other) noexcept
-  {
-    using std::swap;
-    swap(handle_, other.handle_);
-  }
+/// A very thin wrapper around the HDESK data type.
+using Hdesk_guard = Basic_guard<Hdesk_guard_traits>;
 
-  /// @returns The guarded HDESK.
-  HDESK handle() const noexcept
-  {
-    return handle_;
-  }
+/// The guard traits of the HWINSTA data type.
+struct Hwinsta_guard_traits final {
+  /// An alias of the handle type.
+  using Handle = HWINSTA;
 
-  /// @returns The guarded HDESK.
-  operator HDESK() const noexcept
+  /// @returns The value of an empty guard.
+  static Handle sentinel() noexcept
   {
-    return handle();
+    return NULL;
   }
 
-  /// @returns The error code.
-  DWORD close() noexcept
+  /// @returns `true` on success.
+  static bool destroy(const Handle handle) noexcept
   {
-    DWORD result{ERROR_SUCCESS};
-    if (handle_ != NULL) {
-      if (CloseDesktop(handle_))
-        handle_ = NULL;
-      else
-        result = GetLastError();
-    }
-    return result;
+    return CloseWindowStation(handle);
   }
-
-private:
-  HDESK handle_{NULL};
 };
 
 /// A very thin wrapper around the HWINSTA data type.
-class Hwinsta_guard final : private Noncopy {
-public:
-  /// The destructor.
-  ~Hwinsta_guard()
-  {
-    close();
-  }
-
-  /// The constructor.
-  explicit Hwinsta_guard(const HWINSTA handle = NULL) noexcept
-    : handle_{handle}
-  {}
-
-  /// The move constructor.
-  Hwinsta_guard(Hwinsta_guard&& rhs) noexcept
-    : handle_{rhs.handle_}
-  {
-    rhs.handle_ = NULL;
-  }
-
-  /// The move assignment operator.
-  Hwinsta_guard& operator=(Hwinsta_guard&& rhs) noexcept
-  {
-    if (this != &rhs) {
-      Hwinsta_guard tmp{std::move(rhs)};
-      swap(tmp);
-    }
-    return *this;
-  }
-
-  /// The swap operation.
-  void swap(Hwinsta_guard& other) noexcept
-  {
-    using std::swap;
-    swap(handle_, other.handle_);
-  }
-
-  /// @returns The guarded HWINSTA.
-  HWINSTA handle() const noexcept
-  {
-    return handle_;
-  }
-
-  /// @returns The guarded HWINSTA.
-  operator HWINSTA() const noexcept
-  {
-    return handle();
-  }
-
-  /// @returns The error code.
-  DWORD close() noexcept
-  {
-    DWORD result{ERROR_SUCCESS};
-    if (handle_ != NULL) {
-      if (CloseWindowStation(handle_))
-        handle_ = NULL;
-      else
-        result = GetLastError();
-    }
-    return result;
-  }
-
-private:
-  HWINSTA handle_{NULL};
-};
+using Hwinsta_guard = Basic_guard<Hwinsta_guard_traits>;
 
 } // namespace dmitigr::winbase
@@ -26,21 +26,32 @@
 
 namespace dmitigr::winbase::wow64 {
 
-inline int bitness()
-{
+/**
+ * @returns The bitness of Windows.
+ *
+ * @remarks The answer is invariant for the process lifetime, so a 32-bit
+ * process queries it once and caches it; subsequent calls are a load. A
+ * 64-bit process folds to the constant `64`.
+ */
 #if defined(_WIN64)
+constexpr int bitness() noexcept
+{
   return 64;
+}
 #elif defined(_WIN32) && (_WIN32_WINNT >= 0x0A00)
-  USHORT process_machine{};
-  constexpr USHORT* const native_machine{nullptr};
-  const auto e = IsWow64Process2(GetCurrentProcess(),
-    &process_machine, nullptr);
-  if (e)
-    throw Sys_exception{"cannot detemine Windows bitness"};
-  return process_machine == IMAGE_FILE_MACHINE_UNKNOWN ? 32 : 64;
+inline int bitness()
+{
+  static const int result = []
+  {
+    USHORT process_machine{};
+    if (!IsWow64Process2(GetCurrentProcess(), &process_machine, nullptr))
+      throw Sys_exception{"cannot determine Windows bitness"};
+    return process_machine == IMAGE_FILE_MACHINE_UNKNOWN ? 32 : 64;
+  }();
+  return result;
+}
 #else
 #error Unsupported Windows version.
 #endif
-}
 
 } // namespace dmitigr::winbase::wow64
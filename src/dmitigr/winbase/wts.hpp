@@ -25,7 +25,9 @@
 #include <algorithm>
 #include <cstring>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
@@ -35,6 +37,28 @@ namespace dmitigr::winbase::wts {
 
 constexpr const DWORD invalid_session_id{0xFFFFFFFF};
 
+/**
+ * @returns `true` if `value` designates an information class whose payload
+ * is a null-terminated wide string rather than a binary structure.
+ */
+constexpr bool is_wide_string(const WTS_INFO_CLASS value) noexcept
+{
+  switch (value) {
+  case WTSInitialProgram:
+  case WTSApplicationName:
+  case WTSWorkingDirectory:
+  case WTSOEMId:
+  case WTSUserName:
+  case WTSWinStationName:
+  case WTSDomainName:
+  case WTSClientName:
+  case WTSClientDirectory:
+    return true;
+  default:
+    return false;
+  }
+}
+
 class Session_info_by_class final : private Noncopy {
 public:
   ~Session_info_by_class()
@@ -71,8 +95,14 @@ public:
 
   Session_info_by_class& operator=(Session_info_by_class&& rhs) noexcept
   {
-    Session_info_by_class tmp{std::move(rhs)};
-    swap(tmp);
+    // Free and take over directly - no temporary, no triple swap.
+    if (this != &rhs) {
+      if (data_)
+        WTSFreeMemory(data_);
+      data_ = std::exchange(rhs.data_, nullptr);
+      size_in_bytes_ = std::exchange(rhs.size_in_bytes_, DWORD{});
+      info_class_ = std::exchange(rhs.info_class_, WTS_INFO_CLASS{});
+    }
     return *this;
   }
 
@@ -99,17 +129,33 @@ public:
     return size_in_bytes_;
   }
 
+  /**
+   * @returns The view of the wide-string payload.
+   *
+   * @remarks The result refers to the buffer owned by this instance: it is
+   * invalidated by destruction or move. Prefer it over to<std::wstring>()
+   * in polling loops - no allocation, no copy.
+   */
+  std::wstring_view as_wstring_view() const
+  {
+    return to<std::wstring_view>();
+  }
+
   template<typename T>
   T to() const
   {
     using std::is_same_v;
     using D = std::decay_t<T>;
     if constexpr (is_same_v<D, std::wstring_view> || is_same_v<D, std::wstring>) {
-      if (!size_in_bytes_ || (size_in_bytes_ % sizeof(wchar_t)))
+      // The information class, not the payload size, decides whether the
+      // payload is a wide string: a binary structure of even size must
+      // not be misread as one.
+      if (!is_wide_string(info_class_) || !size_in_bytes_)
         throw std::runtime_error{"cannot convert RDP session information to wide"
           " string"};
       return D{data_, size_in_bytes_/sizeof(wchar_t) - 1};
     } else {
+      static_assert(std::is_trivially_copyable_v<D>);
       D result;
       if (!(size_in_bytes_ == sizeof(T)))
         throw std::runtime_error{"cannot convert RDP session information to T"};
@@ -139,6 +185,27 @@ public:
   /// Constructs enumeration of sessions on a Remote Desktop Session Host `server`.
   explicit Session_enumeration(const HANDLE server)
   {
+    refresh(server);
+  }
+
+  /**
+   * @brief Re-enumerates the sessions on the specified `server`.
+   *
+   * @details Polling code should keep one instance and call refresh()
+   * instead of constructing a fresh instance per poll: the previous
+   * result is released and the enumeration re-queried in place.
+   *
+   * @remarks The previous result is released with WTSFreeMemoryExW and
+   * the exact count it was returned with - the pairing WTSEnumerateSessionsExW
+   * requires.
+   */
+  void refresh(const HANDLE server)
+  {
+    if (info_) {
+      WTSFreeMemoryExW(WTSTypeSessionInfoLevel1, info_, info_count_);
+      info_ = {};
+      info_count_ = {};
+    }
     DWORD level{1};
     if (!WTSEnumerateSessionsExW(server, &level, 0, &info_, &info_count_))
       throw Sys_exception{"cannot enumerate server sessions"};
@@ -154,8 +221,13 @@ public:
 
   Session_enumeration& operator=(Session_enumeration&& rhs) noexcept
   {
-    Session_enumeration tmp{std::move(rhs)};
-    swap(tmp);
+    // See Session_info_by_class::operator=(Session_info_by_class&&).
+    if (this != &rhs) {
+      if (info_)
+        WTSFreeMemoryExW(WTSTypeSessionInfoLevel1, info_, info_count_);
+      info_ = std::exchange(rhs.info_, nullptr);
+      info_count_ = std::exchange(rhs.info_count_, DWORD{});
+    }
     return *this;
   }
 
@@ -176,6 +248,30 @@ public:
     return info_count_;
   }
 
+  /// @returns The view of the enumerated sessions.
+  std::span<const WTS_SESSION_INFO_1W> sessions() const noexcept
+  {
+    return {info_, info_count_};
+  }
+
+  /**
+   * @returns The pointer to the first enumerated session.
+   *
+   * @remarks begin()/end() enable range-for and the range algorithms
+   * directly over the WTS-owned array; the iterators are invalidated
+   * by refresh(), move or destruction.
+   */
+  const WTS_SESSION_INFO_1W* begin() const noexcept
+  {
+    return info_;
+  }
+
+  /// @returns The pointer past the last enumerated session.
+  const WTS_SESSION_INFO_1W* end() const noexcept
+  {
+    return info_ + info_count_;
+  }
+
 private:
   PWTS_SESSION_INFO_1W info_{};
   DWORD info_count_{};
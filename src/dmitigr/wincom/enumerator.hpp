@@ -19,10 +19,25 @@
 #include "../winbase/combase.hpp"
 #include "object.hpp"
 
+#include <array>
 #include <optional>
+#include <span>
+#include <type_traits>
 
 namespace dmitigr::wincom {
 
+/**
+ * @brief An enumerator.
+ *
+ * @details Items are fetched from the underlying interface in batches:
+ * every `IEnum*::Next()` call crosses the COM vtable and, for an
+ * out-of-process server, the marshaling boundary, so next() refills an
+ * internal buffer and hands the items out one by one, paying one
+ * round-trip per batch instead of one per item.
+ *
+ * @remarks A copy shares the underlying enumeration cursor but not the
+ * prefetched items; use clone() to get an independent cursor.
+ */
 template<class EnumInterface, class Item>
 class Enumerator final
   : public Unknown_api<Enumerator<EnumInterface, Item>, EnumInterface> {
@@ -30,12 +45,52 @@ class Enumerator final
 public:
   using Ua::Ua;
 
+  ~Enumerator() override
+  {
+    discard_prefetched();
+  }
+
   explicit Enumerator(IUnknown* const api)
   {
     auto instance = Ua::query(api);
     Ua::swap(instance);
   }
 
+  Enumerator(const Enumerator& rhs) noexcept
+    : Ua{rhs}
+  {}
+
+  Enumerator& operator=(const Enumerator& rhs) noexcept
+  {
+    if (this != &rhs) {
+      discard_prefetched();
+      Ua::operator=(rhs);
+    }
+    return *this;
+  }
+
+  Enumerator(Enumerator&& rhs) noexcept
+    : Ua{std::move(rhs)}
+    , buf_{rhs.buf_}
+    , have_{rhs.have_}
+    , pos_{rhs.pos_}
+  {
+    rhs.pos_ = rhs.have_ = 0;
+  }
+
+  Enumerator& operator=(Enumerator&& rhs) noexcept
+  {
+    if (this != &rhs) {
+      discard_prefetched();
+      Ua::operator=(std::move(rhs));
+      buf_ = rhs.buf_;
+      have_ = rhs.have_;
+      pos_ = rhs.pos_;
+      rhs.pos_ = rhs.have_ = 0;
+    }
+    return *this;
+  }
+
   Enumerator clone() const
   {
     EnumInterface* instance{};
@@ -44,12 +99,44 @@ public:
     return Enumerator{instance};
   }
 
+  /**
+   * @returns The next item, or `std::nullopt` if the enumeration is over.
+   *
+   * @remarks The ownership of the item is passed to the caller.
+   */
   std::optional<Item> next()
   {
-    Item result{};
-    ULONG fetched{};
-    Ua::api().Next(1, &result, &fetched);
-    return fetched ? std::make_optional(result) : std::nullopt;
+    if (pos_ == have_) {
+      pos_ = have_ = 0;
+      Ua::api().Next(static_cast<ULONG>(buf_.size()), buf_.data(), &have_);
+      if (!have_)
+        return std::nullopt;
+    }
+    return buf_[pos_++];
+  }
+
+  /**
+   * @brief Fetches up to `items.size()` items in a single round-trip.
+   *
+   * @returns The number of items actually fetched.
+   *
+   * @remarks The ownership of the items is passed to the caller. Items
+   * already prefetched by next() are handed out first.
+   */
+  ULONG next_batch(const std::span<Item> items)
+  {
+    ULONG result{};
+    while (result < items.size() && pos_ < have_)
+      items[result++] = buf_[pos_++];
+    if (pos_ == have_)
+      pos_ = have_ = 0;
+    if (result < items.size()) {
+      ULONG fetched{};
+      Ua::api().Next(static_cast<ULONG>(items.size() - result),
+        items.data() + result, &fetched);
+      result += fetched;
+    }
+    return result;
   }
 
   template<class T>
@@ -62,14 +149,50 @@ public:
 
   void reset()
   {
+    discard_prefetched();
     const auto err = Ua::api().Reset();
     DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot reset enumerator");
   }
 
   void skip(const ULONG count)
   {
-    const auto err = Ua::api().Skip(count);
-    DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot skip enumerator");
+    // The prefetched items count against the skip.
+    ULONG remaining{count};
+    while (remaining && pos_ < have_) {
+      discard_item(buf_[pos_++]);
+      --remaining;
+    }
+    if (pos_ == have_)
+      pos_ = have_ = 0;
+    if (remaining) {
+      const auto err = Ua::api().Skip(remaining);
+      DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot skip enumerator");
+    }
+  }
+
+private:
+  std::array<Item, 32> buf_{};
+  ULONG have_{};
+  ULONG pos_{};
+
+  static void discard_item(Item& item) noexcept
+  {
+    if constexpr (std::is_same_v<Item, VARIANT>)
+      VariantClear(&item);
+    else if constexpr (std::is_pointer_v<Item> &&
+      std::is_base_of_v<IUnknown, std::remove_pointer_t<Item>>) {
+      if (item) {
+        item->Release();
+        item = nullptr;
+      }
+    }
+  }
+
+  void discard_prefetched() noexcept
+  {
+    for (; pos_ < have_; ++pos_)
+      discard_item(buf_[pos_]);
+    pos_ = have_ = 0;
   }
 };
 
@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <charconv>
 #include <new>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include <Winerror.h>
@@ -28,9 +30,8 @@ namespace dmitigr::wincom {
 /// FIXME: inherit from std::system_error
 class Win_error final : public std::runtime_error {
 public:
-  Win_error(std::string message, const long code)
-    : std::runtime_error{message
-        .append(" (error ").append(std::to_string(code)).append(")")}
+  Win_error(const std::string_view message, const long code)
+    : std::runtime_error{what_arg(message, code)}
     , code_{code}
   {}
 
@@ -41,12 +42,40 @@ public:
 
 private:
   long code_{};
+
+  // The code is formatted on the stack with std::to_chars and the
+  // message is built with a single allocation, instead of the up to
+  // four (to_string plus reallocating appends) of the naive chaining.
+  static std::string what_arg(const std::string_view message, const long code)
+  {
+    char buf[16];
+    const auto [p, ec] = std::to_chars(buf, buf + sizeof(buf), code);
+    const auto buf_size = static_cast<std::size_t>(p - buf);
+    std::string result;
+    result.reserve(message.size() + 9 + buf_size);
+    result.append(message).append(" (error ", 8).append(buf, buf_size)
+      .append(1, ')');
+    return result;
+  }
 };
 
 template<typename T>
 inline void check(const T& condition, const std::string& message)
 {
-  if (!static_cast<bool>(condition))
+  if (!static_cast<bool>(condition)) [[unlikely]]
+    throw std::logic_error{message};
+}
+
+/**
+ * @overload
+ *
+ * @remarks Keeps string-literal call sites from converting the message
+ * to std::string (an allocation) on the success path.
+ */
+template<typename T>
+inline void check(const T& condition, const char* const message)
+{
+  if (!static_cast<bool>(condition)) [[unlikely]]
     throw std::logic_error{message};
 }
 
@@ -54,10 +83,11 @@ inline void check(const T& condition, const std::string& message)
 
 #define DMITIGR_WINCOM_THROW_IF_ERROR(error, message)   \
   do {                                                  \
-    if (const HRESULT m__err{error}; FAILED(m__err)) {  \
+    if (const HRESULT m__err{error}; FAILED(m__err))    \
+      [[unlikely]] {                                    \
       if (m__err == E_OUTOFMEMORY)                      \
         throw std::bad_alloc{};                         \
       else                                              \
-        throw Win_error{std::move(message), m__err};    \
+        throw Win_error{message, m__err};               \
     }                                                   \
   } while (false)
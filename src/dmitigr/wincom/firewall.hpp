@@ -18,6 +18,7 @@
 // #pragma comment(lib, "FirewallAPI")
 // #pragma comment(lib, "Hnetcfg")
 
+#include "enumerator.hpp"
 #include "object.hpp"
 
 #include <netfw.h>
@@ -30,24 +31,28 @@ class Authorized_application final : public
 public:
   using Bco::Bco;
 
-  bool is_enabled() const
+  [[nodiscard]] bool is_enabled() const
   {
     VARIANT_BOOL result{VARIANT_FALSE};
-    detail::api(*this).get_Enabled(&result);
-    return result == VARIANT_TRUE;
+    const auto err = detail::api(*this).get_Enabled(&result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err,
+      "cannot get firewall application enabled state");
+    return detail::is_variant_true(result);
   }
 
   Authorized_application& set_enabled(const bool value)
   {
-    const VARIANT_BOOL val{value ? VARIANT_TRUE : VARIANT_FALSE};
+    const auto val = detail::variant_bool(value);
     api().put_Enabled(val);
     return *this;
   }
 
-  NET_FW_IP_VERSION ip_version() const
+  [[nodiscard]] NET_FW_IP_VERSION ip_version() const
   {
     NET_FW_IP_VERSION result{};
-    detail::api(*this).get_IpVersion(&result);
+    const auto err = detail::api(*this).get_IpVersion(&result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err,
+      "cannot get firewall application IP version");
     return result;
   }
 
@@ -66,7 +71,7 @@ public:
   template<class String>
   Authorized_application& set_name(const String& value)
   {
-    api().put_Name(detail::bstr(value));
+    api().put_Name(detail::in_bstr(value));
     return *this;
   }
 
@@ -79,7 +84,7 @@ public:
   template<class String>
   Authorized_application& set_process_image_file_name(const String& value)
   {
-    api().put_ProcessImageFileName(detail::bstr(value));
+    api().put_ProcessImageFileName(detail::in_bstr(value));
     return *this;
   }
 };
@@ -95,7 +100,7 @@ public:
   Authorized_applications& add(const Authorized_application& app)
   {
     const auto err = api().Add(&detail::api(app));
-    if (err != S_OK)
+    if (err != S_OK) [[unlikely]]
       throw Win_error{"cannot add application to firewall collection", err};
     return *this;
   }
@@ -103,9 +108,14 @@ public:
   template<class String>
   Authorized_application& remove(const String& image_file_name)
   {
+    // An empty name is a guaranteed E_INVALIDARG: reject it before the
+    // BSTR conversion and the COM cross-call.
+    if (detail::is_empty_string(image_file_name)) [[unlikely]]
+      throw Win_error{"cannot remove application from firewall collection",
+        E_INVALIDARG};
     const auto err = api().Remove(detail::bstr(image_file_name));
-    if (err != S_OK)
-      throw Win_error{"cannot add application to firewall collection", err};
+    if (err != S_OK) [[unlikely]]
+      throw Win_error{"cannot remove application from firewall collection", err};
     return *this;
   }
 };
@@ -154,10 +164,11 @@ class Manager final : public Basic_com_object<NetFwMgr, INetFwMgr> {
 public:
   using Bco::Bco;
 
-  NET_FW_PROFILE_TYPE current_profile_type() const
+  [[nodiscard]] NET_FW_PROFILE_TYPE current_profile_type() const
   {
     NET_FW_PROFILE_TYPE result{};
-    detail::api(*this).get_CurrentProfileType(&result);
+    const auto err = detail::api(*this).get_CurrentProfileType(&result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot get current firewall profile type");
     return result;
   }
 
@@ -185,7 +196,7 @@ public:
   template<class String>
   Rule& set_name(const String& value)
   {
-    api().put_Name(detail::bstr(value));
+    api().put_Name(detail::in_bstr(value));
     return *this;
   }
 
@@ -198,7 +209,7 @@ public:
   template<class String>
   Rule& set_application_name(const String& image_file_name)
   {
-    api().put_ApplicationName(detail::bstr(image_file_name));
+    api().put_ApplicationName(detail::in_bstr(image_file_name));
     return *this;
   }
 
@@ -211,7 +222,7 @@ public:
   template<class String>
   Rule& set_description(const String& value)
   {
-    api().put_Description(detail::bstr(value));
+    api().put_Description(detail::in_bstr(value));
     return *this;
   }
 
@@ -224,7 +235,7 @@ public:
   template<class String>
   Rule& set_grouping(const String& context)
   {
-    api().put_Grouping(detail::bstr(context));
+    api().put_Grouping(detail::in_bstr(context));
     return *this;
   }
 
@@ -237,7 +248,7 @@ public:
   template<class String>
   Rule& set_interface_types(const String& value)
   {
-    api().put_InterfaceTypes(detail::bstr(value));
+    api().put_InterfaceTypes(detail::in_bstr(value));
     return *this;
   }
 
@@ -250,7 +261,7 @@ public:
   template<class String>
   Rule& set_remote_addresses(const String& value)
   {
-    api().put_RemoteAddresses(detail::bstr(value));
+    api().put_RemoteAddresses(detail::in_bstr(value));
     return *this;
   }
 
@@ -263,14 +274,15 @@ public:
   template<class String>
   Rule& set_remote_ports(const String& value)
   {
-    api().put_RemotePorts(detail::bstr(value));
+    api().put_RemotePorts(detail::in_bstr(value));
     return *this;
   }
 
-  long profiles() const
+  [[nodiscard]] long profiles() const
   {
     long result{};
-    detail::api(*this).get_Profiles(&result);
+    const auto err = detail::api(*this).get_Profiles(&result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot get firewall rule profiles");
     return result;
   }
 
@@ -280,10 +292,11 @@ public:
     return *this;
   }
 
-  long protocol() const
+  [[nodiscard]] long protocol() const
   {
     long result{};
-    detail::api(*this).get_Protocol(&result);
+    const auto err = detail::api(*this).get_Protocol(&result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot get firewall rule protocol");
     return result;
   }
 
@@ -293,16 +306,17 @@ public:
     return *this;
   }
 
-  bool is_enabled() const
+  [[nodiscard]] bool is_enabled() const
   {
     VARIANT_BOOL result{VARIANT_FALSE};
-    detail::api(*this).get_Enabled(&result);
-    return result == VARIANT_TRUE;
+    const auto err = detail::api(*this).get_Enabled(&result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot get firewall rule enabled state");
+    return detail::is_variant_true(result);
   }
 
   Rule& set_enabled(const bool value)
   {
-    const VARIANT_BOOL val{value ? VARIANT_TRUE : VARIANT_FALSE};
+    const auto val = detail::variant_bool(value);
     api().put_Enabled(val);
     return *this;
   }
@@ -318,7 +332,7 @@ public:
   Rules& add(const Rule& rule)
   {
     const auto err = api().Add(&detail::api(rule));
-    if (err != S_OK)
+    if (err != S_OK) [[unlikely]]
       throw Win_error{"cannot add firewall rule", err};
     return *this;
   }
@@ -326,25 +340,48 @@ public:
   template<class String>
   Rules& remove(const String& name)
   {
+    // See Authorized_applications::remove().
+    if (detail::is_empty_string(name)) [[unlikely]]
+      throw Win_error{"cannot remove firewall rule", E_INVALIDARG};
     const auto err = api().Remove(detail::bstr(name));
-    if (err != S_OK)
+    if (err != S_OK) [[unlikely]]
       throw Win_error{"cannot remove firewall rule", err};
     return *this;
   }
 
-  long count() const
+  [[nodiscard]] long count() const
   {
     long result{};
-    detail::api(*this).get_Count(&result);
+    const auto err = detail::api(*this).get_Count(&result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot get firewall rule count");
     return result;
   }
 
+  /**
+   * @returns The enumerator of variants of type `VT_DISPATCH`.
+   *
+   * @remarks Rule instance can be queried from each element of the
+   * returned enumerator as `Rule::query(element.pdispVal)`. Prefer
+   * enumeration over an indexed `for (long i{}; i < count(); ++i)`
+   * loop: the enumerator fetches the rules in batches (see Enumerator),
+   * while the indexed loop pays a COM round-trip for the count on every
+   * iteration and another per item.
+   */
+  Enumerator<IEnumVARIANT, VARIANT> enumerator() const
+  {
+    IUnknown* raw{};
+    detail::api(*this).get__NewEnum(&raw);
+    check(raw, "invalid enumerator retrieved from firewall rules");
+    return Enumerator<IEnumVARIANT, VARIANT>{raw};
+  }
+
   template<class String>
   Rule rule(const String& name) const
   {
     INetFwRule* rul{};
     const auto err = detail::api(*this).Item(detail::bstr(name), &rul);
     if (err != HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) && err != S_OK)
+      [[unlikely]]
       throw Win_error{"cannot retrieve firewall rule", err};
     return Rule{rul};
   }
@@ -364,10 +401,10 @@ public:
   void enable_rule_group(const long profiles, const String& group,
     const bool is_enabled)
   {
-    const VARIANT_BOOL enable{is_enabled ? VARIANT_TRUE : VARIANT_FALSE};
+    const auto enable = detail::variant_bool(is_enabled);
     const auto err = api().EnableRuleGroup(profiles, detail::bstr(group), enable);
-    if (err != S_OK)
-      throw Win_error{L"cannot toggle specified group of firewall rules", err};
+    if (err != S_OK) [[unlikely]]
+      throw Win_error{"cannot toggle specified group of firewall rules", err};
   }
 
   template<typename String>
@@ -376,9 +413,9 @@ public:
     VARIANT_BOOL result{VARIANT_FALSE};
     const auto err = detail::api(*this)
       .get_IsRuleGroupCurrentlyEnabled(detail::bstr(group), &result);
-    if (err != S_OK)
+    if (err != S_OK) [[unlikely]]
       throw Win_error{"cannot get firewall rule group status of current profile", err};
-    return result == VARIANT_TRUE;
+    return detail::is_variant_true(result);
   }
 
   template<typename String>
@@ -387,29 +424,33 @@ public:
     VARIANT_BOOL result{VARIANT_FALSE};
     const auto err = detail::api(*this)
       .IsRuleGroupEnabled(profile, detail::bstr(group), &result);
-    if (err != S_OK)
+    if (err != S_OK) [[unlikely]]
       throw Win_error{"cannot get firewall rule group status", err};
-    return result == VARIANT_TRUE;
+    return detail::is_variant_true(result);
   }
 
-  long current_profile_types() const
+  [[nodiscard]] long current_profile_types() const
   {
     long result{};
-    detail::api(*this).get_CurrentProfileTypes(&result);
+    const auto err = detail::api(*this).get_CurrentProfileTypes(&result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot get current firewall profile types");
     return result;
   }
 
-  bool is_firewall_enabled(const NET_FW_PROFILE_TYPE2 profile) const
+  [[nodiscard]] bool is_firewall_enabled(const NET_FW_PROFILE_TYPE2 profile) const
   {
     VARIANT_BOOL result{VARIANT_FALSE};
-    detail::api(*this).get_FirewallEnabled(profile, &result);
-    return result == VARIANT_TRUE;
+    const auto err = detail::api(*this).get_FirewallEnabled(profile, &result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot get firewall enabled state");
+    return detail::is_variant_true(result);
   }
 
-  NET_FW_MODIFY_STATE local_policy_modify_state() const
+  [[nodiscard]] NET_FW_MODIFY_STATE local_policy_modify_state() const
   {
     NET_FW_MODIFY_STATE result{};
-    detail::api(*this).get_LocalPolicyModifyState(&result);
+    const auto err = detail::api(*this).get_LocalPolicyModifyState(&result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err,
+      "cannot get local firewall policy modify state");
     return result;
   }
 
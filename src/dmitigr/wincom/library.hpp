@@ -29,7 +29,11 @@ class Library final : private Noncopymove {
 public:
   ~Library()
   {
-    CoUninitialize();
+    // Both S_OK and S_FALSE must be balanced by CoUninitialize(); any
+    // other result (e.g. RPC_E_CHANGED_MODE) must not be, or a
+    // caller-owned apartment would be torn down.
+    if (err_ == S_OK || err_ == S_FALSE)
+      CoUninitialize();
   }
 
   Library()
@@ -37,11 +41,14 @@ public:
   {}
 
   explicit Library(const DWORD concurrency_model)
+    : err_{CoInitializeEx(nullptr, concurrency_model)}
   {
-    const auto err = CoInitializeEx(nullptr, concurrency_model);
-    if (err != S_OK && err != S_FALSE)
-      throw Win_error{"cannot initialize COM library", err};
+    if (err_ != S_OK && err_ != S_FALSE)
+      throw Win_error{"cannot initialize COM library", err_};
   }
+
+private:
+  HRESULT err_{E_FAIL};
 };
 
 /**
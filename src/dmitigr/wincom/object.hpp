@@ -20,6 +20,7 @@
 #include "../base/assert.hpp"
 #include "../base/noncopymove.hpp"
 #include "../base/traits.hpp"
+#include "../winbase/combase.hpp"
 #include "../winbase/windows.hpp"
 #include "exceptions.hpp"
 
@@ -30,11 +31,18 @@
 #include <WTypes.h> // MSHCTX, MSHLFLAGS
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
 #include <memory>
+#include <new>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <typeinfo>
 #include <type_traits>
+#include <utility>
 
 namespace dmitigr::wincom {
 
@@ -72,26 +80,30 @@ public:
   {
     static_assert(std::is_base_of_v<IUnknown, U>);
 
-    static const std::string msg{
-      "cannot obtain interface "
-      + std::string{typeid(Api).name()}
-      + " from "
-      + std::string{typeid(U).name()}
-      + " to make "
-      + std::string{typeid(Derived).name()}};
+    // The message is only materialized on failure.
+    static const auto msg = []
+    {
+      return "cannot obtain interface "
+        + std::string{typeid(Api).name()}
+        + " from "
+        + std::string{typeid(U).name()}
+        + " to make "
+        + std::string{typeid(Derived).name()};
+    };
 
-    if (!unknown)
-      throw std::invalid_argument{msg+": null input pointer"};
+    if (!unknown) [[unlikely]]
+      throw std::invalid_argument{msg()+": null input pointer"};
     Api* api{};
     unknown->QueryInterface(&api);
-    if (!api)
-      throw std::runtime_error{msg};
+    if (!api) [[unlikely]]
+      throw std::runtime_error{msg()};
     return Derived{api};
   }
 
   virtual ~Unknown_api()
   {
-    if (api_) {
+    release_queried();
+    if (api_) [[likely]] {
       api_->Release();
       api_ = nullptr;
     }
@@ -105,14 +117,18 @@ public:
 
   Unknown_api(Unknown_api&& rhs) noexcept
     : api_{rhs.api_}
+    , queried_{rhs.queried_}
   {
     rhs.api_ = nullptr;
+    rhs.queried_ = {};
   }
 
+  // The queried-interface cache stays with rhs: the copy re-queries on
+  // demand.
   Unknown_api(const Unknown_api& rhs) noexcept
     : api_{rhs.api_}
   {
-    if (api_)
+    if (api_) [[likely]]
       api_->AddRef();
   }
 
@@ -134,13 +150,45 @@ public:
   {
     using std::swap;
     swap(api_, rhs.api_);
-  }
-
+    swap(queried_, rhs.queried_);
+  }
+
+  /**
+   * @returns The underlying API of type `T`.
+   *
+   * @details For `T` other than `Api` the interface is queried once and
+   * cached per instance, so repeated calls cost a pointer scan instead
+   * of a QueryInterface round-trip (and the cached reference is finally
+   * released by the destructor). The result remains valid for the
+   * lifetime of this instance.
+   */
   template<class T = Api>
   const T& api() const
   {
-    check(api_, "invalid "+std::string{typeid(Derived).name()}+" instance used");
-    return query_interface<T>(const_cast<Api&>(*api_));
+    // The message concatenation must not run on the success path.
+    if (!api_) [[unlikely]]
+      throw std::logic_error{"invalid "
+        +std::string{typeid(Derived).name()}+" instance used"};
+    using D = std::decay_t<T>;
+    if constexpr (std::is_same_v<D, Api>)
+      return *api_;
+    else {
+      for (const auto& [key, ptr] : queried_) {
+        if (key == &typeid(D))
+          return *static_cast<D*>(ptr);
+      }
+      D& result = query_interface<D>(const_cast<Api&>(*api_));
+      for (auto& [key, ptr] : queried_) {
+        if (!key) {
+          key = &typeid(D);
+          ptr = &result;
+          break;
+        }
+      }
+      // On a full cache the reference is simply not cached; it stays
+      // valid, as before, until the underlying object dies.
+      return result;
+    }
   }
 
   template<class T = Api>
@@ -158,6 +206,18 @@ private:
   template<class> friend class Ptr;
 
   Api* api_{};
+  mutable std::array<std::pair<const std::type_info*, IUnknown*>, 4> queried_{};
+
+  void release_queried() noexcept
+  {
+    for (auto& [key, ptr] : queried_) {
+      if (ptr) {
+        ptr->Release();
+        ptr = nullptr;
+      }
+      key = nullptr;
+    }
+  }
 };
 
 // -----------------------------------------------------------------------------
@@ -199,7 +259,8 @@ public:
 
   virtual ~Basic_com_object()
   {
-    if (api_) {
+    release_queried();
+    if (api_) [[likely]] {
       api_->Release();
       api_ = nullptr;
     }
@@ -230,8 +291,10 @@ public:
 
   Basic_com_object(Basic_com_object&& rhs) noexcept
     : api_{rhs.api_}
+    , queried_{rhs.queried_}
   {
     rhs.api_ = nullptr;
+    rhs.queried_ = {};
   }
 
   Basic_com_object& operator=(Basic_com_object&& rhs) noexcept
@@ -245,14 +308,40 @@ public:
   {
     using std::swap;
     swap(api_, rhs.api_);
+    swap(queried_, rhs.queried_);
   }
 
+  /**
+   * @returns The underlying API of type `T`.
+   *
+   * @details Queried interfaces are cached per instance; see
+   * Unknown_api::api() for the details.
+   */
   template<class T = Api>
   const T& api() const
   {
-    check(api_, "invalid "
-      +std::string{typeid(Basic_com_object).name()}+" instance used");
-    return query_interface<T>(const_cast<ObjectInterface&>(*api_));
+    // See Unknown_api::api().
+    if (!api_) [[unlikely]]
+      throw std::logic_error{"invalid "
+        +std::string{typeid(Basic_com_object).name()}+" instance used"};
+    using D = std::decay_t<T>;
+    if constexpr (std::is_same_v<D, ObjectInterface>)
+      return *api_;
+    else {
+      for (const auto& [key, ptr] : queried_) {
+        if (key == &typeid(D))
+          return *static_cast<D*>(ptr);
+      }
+      D& result = query_interface<D>(const_cast<ObjectInterface&>(*api_));
+      for (auto& [key, ptr] : queried_) {
+        if (!key) {
+          key = &typeid(D);
+          ptr = &result;
+          break;
+        }
+      }
+      return result;
+    }
   }
 
   template<class T = Api>
@@ -268,6 +357,18 @@ public:
 
 private:
   ObjectInterface* api_{};
+  mutable std::array<std::pair<const std::type_info*, IUnknown*>, 4> queried_{};
+
+  void release_queried() noexcept
+  {
+    for (auto& [key, ptr] : queried_) {
+      if (ptr) {
+        ptr->Release();
+        ptr = nullptr;
+      }
+      key = nullptr;
+    }
+  }
 };
 
 // -----------------------------------------------------------------------------
@@ -292,29 +393,46 @@ public:
     if (!object)
       return E_POINTER;
 
-    if (id == __uuidof(ComInterface))
-      *object = static_cast<ComInterface*>(this);
-    else if (id == __uuidof(IDispatch))
-      *object = static_cast<IDispatch*>(this);
-    else if (id == __uuidof(IUnknown))
-      *object = static_cast<IUnknown*>(this);
-    else {
-      *object = nullptr;
-      return E_NOINTERFACE;
+    /*
+     * Table QI: the supported IIDs sit in one array scanned by a tight
+     * loop instead of a chain of dependent branches. The interfaces form
+     * a single-inheritance chain (ComInterface -> IDispatch -> IUnknown),
+     * so every entry maps to the same object pointer.
+     */
+    static const IID* const iids[]{
+      &__uuidof(ComInterface), &__uuidof(IDispatch), &__uuidof(IUnknown)};
+    for (const auto* const iid : iids) {
+      if (id == *iid) {
+        *object = static_cast<ComInterface*>(this);
+        AddRef();
+        return S_OK;
+      }
     }
 
-    AddRef();
-    return S_OK;
+    *object = nullptr;
+    return E_NOINTERFACE;
   }
 
   ULONG AddRef() override
   {
-    return ++ref_count_;
+    // Relaxed suffices for taking a reference: acquiring one implies
+    // the caller already holds one.
+    return ref_count_.fetch_add(1, std::memory_order_relaxed) + 1;
   }
 
   ULONG Release() override
   {
-    return ref_count_ = std::max(--ref_count_, ULONG(0));
+    /*
+     * Release ordering publishes all prior writes to whoever drops the
+     * count to zero; the acquire fence on that final path pairs with it.
+     * The sink is owned externally (by Advise_sink_connection), so no
+     * delete happens here.
+     */
+    const auto prev = ref_count_.fetch_sub(1, std::memory_order_release);
+    DMITIGR_ASSERT(prev >= 1); // catches an unbalanced Release()
+    if (prev == 1)
+      std::atomic_thread_fence(std::memory_order_acquire);
+    return prev - 1;
   }
 
   // IDispatch overrides
@@ -347,7 +465,7 @@ public:
   }
 
 private:
-  ULONG ref_count_{};
+  std::atomic<ULONG> ref_count_{};
 };
 
 // -----------------------------------------------------------------------------
@@ -473,11 +591,108 @@ inline _bstr_t bstr(const String& s)
   return _bstr_t{c_str(s)};
 }
 
-inline VARIANT_BOOL variant_bool(const bool value) noexcept
+/**
+ * @overload
+ *
+ * @remarks A view is not null-terminated, so the BSTR is allocated from
+ * the data/size pair directly and attached to the result. (Wide C strings
+ * and std::wstring need no such treatment - _bstr_t's wide constructor
+ * already allocates without a code-page conversion.)
+ */
+inline _bstr_t bstr(const std::wstring_view s)
+{
+  const BSTR value{SysAllocStringLen(s.data(), static_cast<UINT>(s.size()))};
+  if (!value)
+    throw std::bad_alloc{};
+  return _bstr_t{value, false}; // attach
+}
+
+/// @returns `true` if the string `s` is empty or null.
+template<typename String>
+inline bool is_empty_string(const String& s) noexcept
+{
+  if constexpr (std::is_pointer_v<std::decay_t<String>>)
+    return !s || !*s;
+  else
+    return s.empty();
+}
+
+/**
+ * @brief A reusable BSTR buffer.
+ *
+ * @details Converting an argument with SysAllocString per call and
+ * freeing it right after churns the OLE allocator - a known contention
+ * point. A scratch instance (typically thread_local) reuses one
+ * allocation: SysReAllocStringLen keeps the block when the capacity
+ * suffices, so N conversions cost ~1 allocation amortized.
+ */
+class Bstr_scratch final : private Noncopymove {
+public:
+  ~Bstr_scratch()
+  {
+    if (value_)
+      SysFreeString(value_);
+  }
+
+  Bstr_scratch() = default;
+
+  /// @returns The scratch BSTR holding a copy of `value`.
+  BSTR assign(const std::wstring_view value)
+  {
+    if (!SysReAllocStringLen(&value_, value.data(),
+        static_cast<UINT>(value.size())))
+      throw std::bad_alloc{};
+    return value_;
+  }
+
+private:
+  BSTR value_{};
+};
+
+/// A scope guard which owns a BSTR and frees it with SysFreeString().
+class Bstr_guard final : private Noncopymove {
+public:
+  ~Bstr_guard()
+  {
+    SysFreeString(value_);
+  }
+
+  explicit Bstr_guard(const BSTR value) noexcept
+    : value_{value}
+  {}
+
+private:
+  BSTR value_{};
+};
+
+/**
+ * @returns The BSTR representation of `s` suitable for an `[in]`
+ * parameter of a COM call, which must not be retained by the callee.
+ *
+ * @remarks Wide inputs reuse a per-thread scratch BSTR; narrow inputs
+ * keep the converting _bstr_t path.
+ */
+template<typename String>
+inline auto in_bstr(const String& s)
+{
+  if constexpr (std::is_convertible_v<const String&, std::wstring_view>) {
+    thread_local Bstr_scratch scratch;
+    return scratch.assign(s);
+  } else
+    return bstr(s);
+}
+
+constexpr VARIANT_BOOL variant_bool(const bool value) noexcept
 {
   return value ? VARIANT_TRUE : VARIANT_FALSE;
 }
 
+/// @returns `true` if `value` is `VARIANT_TRUE`.
+constexpr bool is_variant_true(const VARIANT_BOOL value) noexcept
+{
+  return value == VARIANT_TRUE;
+}
+
 template<class Wrapper, class Api, typename T, typename U>
 void set(const char* const what,
   const Wrapper& wrapper, HRESULT(Api::* setter)(T),
@@ -540,8 +755,203 @@ String get(const Wrapper& wrapper, HRESULT(Api::* getter)(BSTR*))
     else
       throw std::runtime_error{"cannot get BSTR value"};
   }
-  _bstr_t tmp{value, false}; // take ownership
-  return String(tmp);
+
+  using D = std::decay_t<Optional_value_t<String>>;
+  if constexpr (std::is_same_v<D, std::wstring>) {
+    // Construct straight from the BSTR: the _bstr_t wrapper would cost
+    // an extra heap allocation (its refcounted control block) per call.
+    const Bstr_guard guard{value};
+    return D{value, SysStringLen(value)};
+  } else if constexpr (std::is_same_v<D, std::string>) {
+    // One UTF-16 to UTF-8 conversion instead of _bstr_t's lossy CP_ACP.
+    const Bstr_guard guard{value};
+    return winbase::com::to_string(value);
+  } else {
+    _bstr_t tmp{value, false}; // take ownership
+    return String(tmp);
+  }
+}
+
+/**
+ * @brief Assigns the result of `getter` to `result`.
+ *
+ * @details Unlike the value-returning overload, reuses the capacity of
+ * `result`, so a loop fetching strings from many objects into the same
+ * buffer allocates only when the buffer has to grow.
+ */
+template<class Wrapper, class Api>
+void get(const Wrapper& wrapper, HRESULT(Api::* getter)(BSTR*),
+  std::wstring& result)
+{
+  DMITIGR_ASSERT(getter);
+  BSTR value{};
+  (detail::api<Api>(wrapper).*getter)(&value);
+  if (!value)
+    throw std::runtime_error{"cannot get BSTR value"};
+  const Bstr_guard guard{value};
+  result.assign(value, SysStringLen(value));
+}
+
+/**
+ * @brief A batching input iterator over a COM collection.
+ *
+ * @details Iterating a collection via count() plus item(index) costs one
+ * round trip per element. This iterator drains the IEnumVARIANT of the
+ * collection 32 elements per Next() call instead, amortizing the round
+ * trip across the batch. Elements the enumerator yields that don't expose
+ * `Item::Api` are skipped.
+ */
+template<class Item>
+class Enum_iterator final {
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = Item;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Item*;
+  using reference = const Item&;
+
+  /// Constructs the past-the-end iterator.
+  Enum_iterator() = default;
+
+  /// Constructs the begin iterator. Takes the ownership of `enumerator`.
+  explicit Enum_iterator(IEnumVARIANT* const enumerator)
+    : enumerator_{enumerator}
+  {
+    DMITIGR_ASSERT(enumerator_);
+    advance();
+  }
+
+  ~Enum_iterator()
+  {
+    while (pos_ < fetched_)
+      VariantClear(&buf_[pos_++]);
+    if (enumerator_)
+      enumerator_->Release();
+  }
+
+  Enum_iterator(const Enum_iterator&) = delete;
+  Enum_iterator& operator=(const Enum_iterator&) = delete;
+
+  Enum_iterator(Enum_iterator&& rhs) noexcept
+    : enumerator_{rhs.enumerator_}
+    , fetched_{rhs.fetched_}
+    , pos_{rhs.pos_}
+    , item_{std::move(rhs.item_)}
+  {
+    std::copy(rhs.buf_ + pos_, rhs.buf_ + fetched_, buf_ + pos_);
+    rhs.enumerator_ = {};
+    rhs.fetched_ = rhs.pos_ = 0;
+    rhs.item_ = Item{};
+  }
+
+  Enum_iterator& operator=(Enum_iterator&& rhs) noexcept
+  {
+    if (this != &rhs) {
+      Enum_iterator tmp{std::move(rhs)};
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  void swap(Enum_iterator& other) noexcept
+  {
+    using std::swap;
+    swap(enumerator_, other.enumerator_);
+    swap(buf_, other.buf_);
+    swap(fetched_, other.fetched_);
+    swap(pos_, other.pos_);
+    swap(item_, other.item_);
+  }
+
+  const Item& operator*() const noexcept
+  {
+    return item_;
+  }
+
+  const Item* operator->() const noexcept
+  {
+    return &item_;
+  }
+
+  Enum_iterator& operator++()
+  {
+    advance();
+    return *this;
+  }
+
+  void operator++(int)
+  {
+    advance();
+  }
+
+  bool operator==(const Enum_iterator& rhs) const noexcept
+  {
+    return static_cast<bool>(item_) == static_cast<bool>(rhs.item_);
+  }
+
+  bool operator!=(const Enum_iterator& rhs) const noexcept
+  {
+    return !(*this == rhs);
+  }
+
+private:
+  constexpr static ULONG batch_size_{32};
+  IEnumVARIANT* enumerator_{};
+  VARIANT buf_[batch_size_]{};
+  ULONG fetched_{};
+  ULONG pos_{};
+  Item item_;
+
+  void advance()
+  {
+    item_ = Item{};
+    while (true) {
+      if (pos_ == fetched_) {
+        if (!enumerator_)
+          return;
+        fetched_ = pos_ = 0;
+        const auto err = enumerator_->Next(batch_size_, buf_, &fetched_);
+        if (err != S_OK && err != S_FALSE)
+          DMITIGR_WINCOM_THROW_IF_ERROR(err,
+            "cannot get next elements of IEnumVARIANT");
+        if (!fetched_) {
+          enumerator_->Release();
+          enumerator_ = {};
+          return;
+        }
+      }
+      auto& elem = buf_[pos_++];
+      typename Item::Api* raw{};
+      if (elem.vt == VT_DISPATCH && elem.pdispVal)
+        elem.pdispVal->QueryInterface(&raw);
+      else if (elem.vt == VT_UNKNOWN && elem.punkVal)
+        elem.punkVal->QueryInterface(&raw);
+      VariantClear(&elem);
+      if (raw) {
+        item_ = Item{raw};
+        return;
+      }
+    }
+  }
+};
+
+/// @returns The begin iterator over the collection `wrapper`.
+template<class Item, class Wrapper, class Api>
+Enum_iterator<Item> enum_begin(const Wrapper& wrapper,
+  HRESULT(Api::* getter)(IUnknown**))
+{
+  DMITIGR_ASSERT(getter);
+  IUnknown* enum_unknown{};
+  const auto err = (api<Api>(wrapper).*getter)(&enum_unknown);
+  DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot get enumerator of collection");
+  if (!enum_unknown)
+    throw std::runtime_error{"cannot get enumerator of collection"};
+  IEnumVARIANT* enumerator{};
+  enum_unknown->QueryInterface(&enumerator);
+  enum_unknown->Release();
+  if (!enumerator)
+    throw std::runtime_error{"cannot get IEnumVARIANT of collection"};
+  return Enum_iterator<Item>{enumerator};
 }
 
 } // namespace detail
@@ -17,7 +17,6 @@
 #pragma once
 
 #include "../base/assert.hpp"
-#include "../base/utility.hpp"
 #include "../winbase/windows.hpp"
 #include "enumerator.hpp"
 #include "exceptions.hpp"
@@ -33,7 +32,9 @@
 #include <optional>
 #include <exception>
 #include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace dmitigr::wincom::rdp {
 
@@ -59,7 +60,7 @@ public:
     return detail::get<String>(*this, &Api::get_ConnectionString);
   }
 
-  bool is_revoked() const
+  [[nodiscard]] bool is_revoked() const
   {
     VARIANT_BOOL result{VARIANT_FALSE};
     detail::api(*this).get_Revoked(&result);
@@ -90,32 +91,63 @@ public:
       detail::bstr(password),
       limit,
       &invitation);
-    if (err != S_OK)
+    if (err != S_OK) [[unlikely]]
       throw Win_error{"cannot create IRDPSRAPIInvitation instance", err};
     return Invitation{invitation};
   }
 
-  long invitation_count() const
+  [[nodiscard]] long invitation_count() const
   {
     long result{};
     detail::api(*this).get_Count(&result);
     return result;
   }
 
+  /**
+   * @par Exception safety guarantee
+   * Throws std::out_of_range if `index` is out of range.
+   *
+   * @remarks The range check is delegated to the underlying get_Item()
+   * call, which fails for an out-of-range index: a pre-check via
+   * invitation_count() would cost a second COM round-trip per lookup.
+   */
   Invitation invitation(const long index) const
   {
-    if (!(index < invitation_count()))
-      throw std::out_of_range{"invitation index out of range"};
-
     IRDPSRAPIInvitation* raw{};
     VARIANT idx{};
-    VariantInit(&idx);
     idx.vt = VT_I4;
     idx.lVal = index;
-    detail::api(*this).get_Item(idx, &raw);
+    const auto err = detail::api(*this).get_Item(idx, &raw);
+    if (err != S_OK) [[unlikely]]
+      throw std::out_of_range{"invitation index out of range"};
     check(raw, "invalid invitation retrieved from invitation manager");
     return Invitation{raw};
   }
+
+  /**
+   * @returns All the invitations at the point of the call.
+   *
+   * @remarks invitation() pays two COM calls per access - get_Count()
+   * for the bounds check plus get_Item(). The snapshot pays get_Count()
+   * once and one get_Item() per element, so prefer it for iterating over
+   * the invitations, especially across an apartment boundary.
+   */
+  std::vector<Invitation> invitations() const
+  {
+    const auto count = invitation_count();
+    std::vector<Invitation> result;
+    result.reserve(static_cast<std::size_t>(count));
+    VARIANT idx{};
+    idx.vt = VT_I4;
+    for (long i{}; i < count; ++i) {
+      idx.lVal = i;
+      IRDPSRAPIInvitation* raw{};
+      detail::api(*this).get_Item(idx, &raw);
+      check(raw, "invalid invitation retrieved from invitation manager");
+      result.emplace_back(Invitation{raw});
+    }
+    return result;
+  }
 };
 
 class Tcp_connection_info final
@@ -130,7 +162,7 @@ public:
     return detail::get<String>(*this, &Api::get_LocalIP);
   }
 
-  long local_port() const
+  [[nodiscard]] long local_port() const
   {
     long result{};
     detail::api(*this).get_LocalPort(&result);
@@ -143,19 +175,45 @@ public:
     return detail::get<String>(*this, &Api::get_PeerIP);
   }
 
-  long remote_port() const
+  [[nodiscard]] long remote_port() const
   {
     long result{};
     detail::api(*this).get_PeerPort(&result);
     return result;
   }
 
-  long protocol() const
+  [[nodiscard]] long protocol() const
   {
     long result{};
     detail::api(*this).get_Protocol(&result);
     return result;
   }
+
+  /// A plain snapshot of the connection information.
+  struct Snapshot final {
+    std::wstring local_address;
+    std::wstring remote_address;
+    long local_port{};
+    long remote_port{};
+    long protocol{};
+  };
+
+  /**
+   * @returns All the fields of this instance fetched back-to-back.
+   *
+   * @remarks Bulk consumers (say, a table of attendees) should copy the
+   * data out once and release the COM object instead of holding one per
+   * row and re-fetching fields on demand.
+   */
+  Snapshot snapshot() const
+  {
+    return Snapshot{
+      local_address<std::wstring>(),
+      remote_address<std::wstring>(),
+      local_port(),
+      remote_port(),
+      protocol()};
+  }
 };
 
 class Attendee final : public
@@ -164,34 +222,38 @@ class Attendee final : public
 public:
   using Ua::Ua;
 
-  long id() const
+  [[nodiscard]] long id() const
   {
     long result{};
     detail::api(*this).get_Id(&result);
     return result;
   }
 
-  RDPENCOMAPI_ATTENDEE_FLAGS flags() const
+  [[nodiscard]] RDPENCOMAPI_ATTENDEE_FLAGS flags() const
   {
     long result{};
     detail::api(*this).get_Flags(&result);
     return static_cast<RDPENCOMAPI_ATTENDEE_FLAGS>(result);
   }
 
-  bool is_local() const
+  [[nodiscard]] bool is_local() const
   {
     return flags() == ATTENDEE_FLAGS_LOCAL;
   }
 
+  /// @returns The connection info, or invalid instance if unavailable.
   Tcp_connection_info tcp_connection_info() const
   {
     IUnknown* info{};
     detail::api(*this).get_ConnectivityInfo(&info);
     check(info, "invalid connectivity info retrieved from attendee");
-    try {
-      return Tcp_connection_info::query(info);
-    } catch (const std::runtime_error&) {}
-    return Tcp_connection_info{};
+    // A failed query yields a null interface and thus an invalid result
+    // instance - no need to route that expected outcome through
+    // Tcp_connection_info::query() and a swallowed exception.
+    IRDPSRAPITcpConnectionInfo* raw{};
+    info->QueryInterface(&raw);
+    info->Release();
+    return Tcp_connection_info{raw};
   }
 
   void set_control_level(const CTRL_LEVEL level)
@@ -199,7 +261,7 @@ public:
     api().put_ControlLevel(level);
   }
 
-  CTRL_LEVEL control_level() const
+  [[nodiscard]] CTRL_LEVEL control_level() const
   {
     CTRL_LEVEL result{};
     detail::api(*this).get_ControlLevel(&result);
@@ -262,14 +324,14 @@ public:
     return Attendee{raw};
   }
 
-  long code() const
+  [[nodiscard]] long code() const
   {
     long val{};
     detail::api(*this).get_Code(&val);
     return val;
   }
 
-  ATTENDEE_DISCONNECT_REASON reason() const
+  [[nodiscard]] ATTENDEE_DISCONNECT_REASON reason() const
   {
     ATTENDEE_DISCONNECT_REASON val{};
     detail::api(*this).get_Reason(&val);
@@ -286,11 +348,11 @@ public:
   Session_properties&
   set_clipboard_redirect_enabled(const bool value)
   {
+    // VARIANT{} zero-initializes (VT_EMPTY), so VariantInit() is redundant.
     VARIANT val{};
-    VariantInit(&val);
     val.vt = VT_BOOL;
-    val.boolVal = value ? VARIANT_TRUE : VARIANT_FALSE;
-    api().put_Property(_bstr_t{"EnableClipboardRedirect"}, val);
+    val.boolVal = detail::variant_bool(value);
+    api().put_Property(enable_clipboard_redirect(), val);
     return *this;
   }
 
@@ -298,10 +360,9 @@ public:
   set_clipboard_redirect_callback(IRDPSRAPIClipboardUseEvents* const value)
   {
     VARIANT val{};
-    VariantInit(&val);
     val.vt = VT_UNKNOWN;
     val.punkVal = value;
-    api().put_Property(_bstr_t{"SetClipboardRedirectCallback"}, val);
+    api().put_Property(set_clipboard_redirect_callback_name(), val);
     return *this;
   }
 
@@ -309,20 +370,40 @@ public:
   set_default_attendee_control_level(const CTRL_LEVEL value)
   {
     VARIANT val{};
-    VariantInit(&val);
     val.vt = VT_I4;
     val.lVal = value;
-    api().put_Property(_bstr_t{"DefaultAttendeeControlLevel"}, val);
+    api().put_Property(default_attendee_control_level_name(), val);
     return *this;
   }
 
-  CTRL_LEVEL default_attendee_control_level() const
+  [[nodiscard]] CTRL_LEVEL default_attendee_control_level() const
   {
     VARIANT val{};
-    VariantInit(&val);
-    detail::api(*this).get_Property(_bstr_t{"DefaultAttendeeControlLevel"}, &val);
+    detail::api(*this).get_Property(default_attendee_control_level_name(), &val);
     return static_cast<CTRL_LEVEL>(val.lVal);
   }
+
+private:
+  // The property names are allocated (SysAllocString) once per process
+  // rather than per call. put_Property()/get_Property() take the name as
+  // an [in] parameter and don't assume the ownership.
+  static const _bstr_t& enable_clipboard_redirect()
+  {
+    static const _bstr_t result{L"EnableClipboardRedirect"};
+    return result;
+  }
+
+  static const _bstr_t& set_clipboard_redirect_callback_name()
+  {
+    static const _bstr_t result{L"SetClipboardRedirectCallback"};
+    return result;
+  }
+
+  static const _bstr_t& default_attendee_control_level_name()
+  {
+    static const _bstr_t result{L"DefaultAttendeeControlLevel"};
+    return result;
+  }
 };
 
 // -----------------------------------------------------------------------------
@@ -334,28 +415,35 @@ class Basic_rdp_peer : private Noncopymove {
 public:
   using Com = BasicComObject;
 
-  virtual ~Basic_rdp_peer() = default;
-
-  Basic_rdp_peer(std::unique_ptr<BasicComObject> com,
-    std::unique_ptr<Event_dispatcher> sink)
-    : com_{forward_or_throw<std::invalid_argument>(std::move(com),
-      "Basic_rdp_peer(com)")}
-    , sink_{com_->api(), std::move(sink), this}
+  /**
+   * @remarks The COM object is stored by value - it's a move-only wrapper
+   * of one interface pointer, so the indirection (and the allocation) of
+   * a smart pointer would buy nothing. An invalid `com` is rejected by
+   * the api() call in the member initializer.
+   */
+  Basic_rdp_peer(BasicComObject com, std::unique_ptr<Event_dispatcher> sink)
+    : com_{std::move(com)}
+    , sink_{com_.api(), std::move(sink), this}
   {}
 
   const BasicComObject& com() const noexcept
   {
-    return *com_;
+    return com_;
   }
 
   BasicComObject& com() noexcept
   {
-    return const_cast<BasicComObject&>(
-      static_cast<const Basic_rdp_peer*>(this)->com());
+    return com_;
   }
 
+protected:
+  // Non-virtual: the peers are never deleted through a base pointer, and
+  // a virtual destructor would put a vtable pointer into every peer for
+  // that sole purpose.
+  ~Basic_rdp_peer() = default;
+
 private:
-  std::unique_ptr<BasicComObject> com_;
+  BasicComObject com_;
   Advise_sink_connection<Event_dispatcher> sink_;
 };
 
@@ -377,7 +465,7 @@ public:
   {
     if (!is_open_) {
       const auto err = com().api().Open();
-      if (err != S_OK)
+      if (err != S_OK) [[unlikely]]
         throw Win_error{"cannot open RDP server", err};
       is_open_ = true;
     }
@@ -387,13 +475,13 @@ public:
   {
     if (is_open_) {
       const auto err = com().api().Close();
-      if (err != S_OK)
+      if (err != S_OK) [[unlikely]]
         throw Win_error{"cannot close RDP server", err};
       is_open_ = false;
     }
   }
 
-  bool is_open() const noexcept
+  [[nodiscard]] bool is_open() const noexcept
   {
     return is_open_;
   }
@@ -425,14 +513,14 @@ public:
   void pause()
   {
     const auto err = com().api().Pause();
-    if (err != S_OK)
+    if (err != S_OK) [[unlikely]]
       throw Win_error{"cannot pause RDP server", err};
   }
 
   void resume()
   {
     const auto err = com().api().Resume();
-    if (err != S_OK)
+    if (err != S_OK) [[unlikely]]
       throw Win_error{"cannot resume RDP server", err};
   }
 
@@ -465,16 +553,16 @@ private:
 
 class Client final : public Client_base {
 public:
-  explicit Client(std::unique_ptr<Viewer> com)
+  explicit Client(Viewer com)
     : Client{std::move(com), nullptr}
   {}
 
-  Client(std::unique_ptr<Viewer> com, std::unique_ptr<Event_dispatcher> sink)
+  Client(Viewer com, std::unique_ptr<Event_dispatcher> sink)
     : Client_base{std::move(com),
       std::make_unique<detail::Viewer_event_dispatcher>(std::move(sink))}
   {}
 
-  ~Client() override
+  ~Client()
   {
     try {
       close();
@@ -488,12 +576,12 @@ public:
     using wincom::detail::bstr;
     const auto err = com().api().Connect(bstr(connection_string),
       bstr(name), bstr(password));
-    if (err != S_OK)
+    if (err != S_OK) [[unlikely]]
       throw Win_error{"cannot open RDP client", err};
     is_open_ = true;
   }
 
-  bool is_open() const
+  [[nodiscard]] bool is_open() const
   {
     return is_open_;
   }
@@ -502,13 +590,13 @@ public:
   {
     if (is_open_) {
       const auto err = com().api().Disconnect();
-      if (err != S_OK)
+      if (err != S_OK) [[unlikely]]
         throw Win_error{"cannot close RDP client", err};
       is_open_ = is_authenticated_ = false;
     }
   }
 
-  bool is_authenticated() const
+  [[nodiscard]] bool is_authenticated() const
   {
     return is_authenticated_;
   }
@@ -519,7 +607,7 @@ public:
   void set_control_level(const CTRL_LEVEL level)
   {
     const auto err = com().api().RequestControl(level);
-    if (err != S_OK)
+    if (err != S_OK) [[unlikely]]
       throw Win_error{"cannot set control level of RDP client", err};
   }
 
@@ -537,16 +625,25 @@ public:
    */
   Attendee attendee() const
   {
-    if (!attendee_id_) {
-      auto atts = attendee_manager().attendees();
-      while (auto att = atts.next()) {
-        if (auto a = rdp::Attendee::query(att->pdispVal); a.is_local()) {
-          attendee_id_ = a.id();
-          return a;
-        }
-      }
-    } else
+    // Once the local attendee is known its id is cached, and subsequent
+    // calls are a single get_Item() instead of a scan of the enumeration.
+    if (attendee_id_)
       return attendee_manager().attendee(*attendee_id_);
+    auto atts = attendee_manager().attendees();
+    while (auto att = atts.next()) {
+      // The enumerator passes the ownership of the item, so the variant
+      // must be cleared whether or not the element is the local attendee.
+      IRDPSRAPIAttendee* raw{};
+      if (att->pdispVal)
+        att->pdispVal->QueryInterface(&raw);
+      VariantClear(&*att);
+      if (!raw) [[unlikely]]
+        continue;
+      if (Attendee a{raw}; a.is_local()) {
+        attendee_id_ = a.id();
+        return a;
+      }
+    }
     return Attendee{};
   }
 
@@ -564,7 +661,7 @@ public:
     com().api().put_SmartSizing(val);
   }
 
-  bool is_smart_sizing_enabled() const
+  [[nodiscard]] bool is_smart_sizing_enabled() const
   {
     VARIANT_BOOL result{VARIANT_FALSE};
     wincom::detail::api(com()).get_SmartSizing(&result);
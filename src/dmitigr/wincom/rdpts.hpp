@@ -21,6 +21,7 @@
 #include "object.hpp"
 
 #include <chrono>
+#include <optional>
 #include <type_traits>
 
 #import "libid:8C11EFA1-92C3-11D1-BC1E-00C04FA31489"
@@ -62,6 +63,78 @@ public:
     lan = 6
   };
 
+  /// The settings to apply at once; unset members are left untouched.
+  struct Config final {
+    std::optional<LONG> rdp_port;
+    std::optional<bool> smart_sizing_enabled;
+    std::optional<std::chrono::seconds> overall_connection_timeout;
+    std::optional<std::chrono::seconds> single_connection_timeout;
+    std::optional<std::chrono::seconds> shutdown_timeout;
+    std::optional<std::chrono::minutes> idle_timeout;
+    std::optional<bool> redirect_drives_enabled;
+    std::optional<bool> redirect_ports_enabled;
+    std::optional<bool> redirect_printers_enabled;
+    std::optional<bool> redirect_smart_cards_enabled;
+    std::optional<std::chrono::milliseconds> keep_alive_interval;
+    std::optional<bool> auto_reconnect_enabled;
+    std::optional<LONG> max_reconnect_attempts;
+    std::optional<Server_authentication> authentication_level;
+    std::optional<bool> redirect_clipboard_enabled;
+    std::optional<bool> redirect_devices_enabled;
+    std::optional<bool> redirect_pos_devices_enabled;
+    std::optional<Network_connection_type> network_connection_type;
+  };
+
+  /**
+   * @brief Applies every set member of `config` in declaration order.
+   *
+   * @details Typical session setup touches a dozen or more properties;
+   * gathering them into one Config keeps the configuration in one place
+   * and one call instead of a long chain of individual setters. Each set
+   * member still costs its own put_ call - the interface has no bulk
+   * setter - and the first failure throws, leaving the already-applied
+   * members in effect.
+   */
+  void apply(const Config& config)
+  {
+    if (config.rdp_port)
+      set_rdp_port(*config.rdp_port);
+    if (config.smart_sizing_enabled)
+      set_smart_sizing_enabled(*config.smart_sizing_enabled);
+    if (config.overall_connection_timeout)
+      set_overall_connection_timeout(*config.overall_connection_timeout);
+    if (config.single_connection_timeout)
+      set_single_connection_timeout(*config.single_connection_timeout);
+    if (config.shutdown_timeout)
+      set_shutdown_timeout(*config.shutdown_timeout);
+    if (config.idle_timeout)
+      set_idle_timeout(*config.idle_timeout);
+    if (config.redirect_drives_enabled)
+      set_redirect_drives_enabled(*config.redirect_drives_enabled);
+    if (config.redirect_ports_enabled)
+      set_redirect_ports_enabled(*config.redirect_ports_enabled);
+    if (config.redirect_printers_enabled)
+      set_redirect_printers_enabled(*config.redirect_printers_enabled);
+    if (config.redirect_smart_cards_enabled)
+      set_redirect_smart_cards_enabled(*config.redirect_smart_cards_enabled);
+    if (config.keep_alive_interval)
+      set_keep_alive_interval(*config.keep_alive_interval);
+    if (config.auto_reconnect_enabled)
+      set_auto_reconnect_enabled(*config.auto_reconnect_enabled);
+    if (config.max_reconnect_attempts)
+      set_max_reconnect_attempts(*config.max_reconnect_attempts);
+    if (config.authentication_level)
+      set_authentication_level(*config.authentication_level);
+    if (config.redirect_clipboard_enabled)
+      set_redirect_clipboard_enabled(*config.redirect_clipboard_enabled);
+    if (config.redirect_devices_enabled)
+      set_redirect_devices_enabled(*config.redirect_devices_enabled);
+    if (config.redirect_pos_devices_enabled)
+      set_redirect_pos_devices_enabled(*config.redirect_pos_devices_enabled);
+    if (config.network_connection_type)
+      set_network_connection_type(*config.network_connection_type);
+  }
+
   // IMsRdpClientAdvancedSettings
 
   void set_rdp_port(const LONG value)
@@ -69,7 +142,7 @@ public:
     detail::set("RDP port", *this, &Api::put_RDPPort, value);
   }
 
-  LONG rdp_port() const
+  [[nodiscard]] LONG rdp_port() const
   {
     return detail::get("RDP port", *this, &Api::get_RDPPort);
   }
@@ -80,7 +153,7 @@ public:
       *this, &Api::put_SmartSizing, value);
   }
 
-  bool is_smart_sizing_enabled() const noexcept
+  [[nodiscard]] bool is_smart_sizing_enabled() const
   {
     return detail::get_bool("smart sizing enabled", *this, &Api::get_SmartSizing);
   }
@@ -91,7 +164,7 @@ public:
       *this, &Api::put_overallConnectionTimeout, value.count());
   }
 
-  std::chrono::seconds overall_connection_timeout() const
+  [[nodiscard]] std::chrono::seconds overall_connection_timeout() const
   {
     return std::chrono::seconds{detail::get("overall connection timeout",
       *this, &Api::get_overallConnectionTimeout)};
@@ -103,7 +176,7 @@ public:
     DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot set single connection timeout");
   }
 
-  std::chrono::seconds single_connection_timeout() const
+  [[nodiscard]] std::chrono::seconds single_connection_timeout() const
   {
     LONG result{};
     const auto err = detail::api(*this).get_singleConnectionTimeout(&result);
@@ -117,7 +190,7 @@ public:
     DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot set shutdown timeout");
   }
 
-  std::chrono::seconds shutdown_timeout() const
+  [[nodiscard]] std::chrono::seconds shutdown_timeout() const
   {
     LONG result{};
     const auto err = detail::api(*this).get_shutdownTimeout(&result);
@@ -131,7 +204,7 @@ public:
     DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot set idle timeout");
   }
 
-  std::chrono::minutes idle_timeout() const
+  [[nodiscard]] std::chrono::minutes idle_timeout() const
   {
     LONG result{};
     const auto err = detail::api(*this).get_MinutesToIdleTimeout(&result);
@@ -145,7 +218,7 @@ public:
       *this, &Api::put_RedirectDrives, value);
   }
 
-  bool is_redirect_drives_enabled() const
+  [[nodiscard]] bool is_redirect_drives_enabled() const
   {
     return detail::get_bool("redirect drives enabled",
       *this, &Api::get_RedirectDrives);
@@ -157,7 +230,7 @@ public:
       *this, &Api::put_RedirectPorts, value);
   }
 
-  bool is_redirect_port_enabled() const
+  [[nodiscard]] bool is_redirect_port_enabled() const
   {
     return detail::get_bool("redirect ports enabled",
       *this, &Api::get_RedirectPorts);
@@ -169,7 +242,7 @@ public:
       *this, &Api::put_RedirectPrinters, value);
   }
 
-  bool is_redirect_printers_enabled() const
+  [[nodiscard]] bool is_redirect_printers_enabled() const
   {
     return detail::get_bool("redirect printers enabled",
       *this, &Api::get_RedirectPrinters);
@@ -181,7 +254,7 @@ public:
       *this, &Api::put_RedirectSmartCards, value);
   }
 
-  bool is_redirect_smart_cards_enabled() const
+  [[nodiscard]] bool is_redirect_smart_cards_enabled() const
   {
     return detail::get_bool("redirect smart cards enabled",
       *this, &Api::get_RedirectSmartCards);
@@ -194,7 +267,7 @@ public:
     DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot set keep-alive interval");
   }
 
-  std::chrono::milliseconds keep_alive_interval() const
+  [[nodiscard]] std::chrono::milliseconds keep_alive_interval() const
   {
     LONG result{};
     const auto err = detail::api(*this).get_keepAliveInterval(&result);
@@ -210,7 +283,7 @@ public:
       *this, &Api::put_EnableAutoReconnect, value);
   }
 
-  bool is_auto_reconnect_enabled() const
+  [[nodiscard]] bool is_auto_reconnect_enabled() const
   {
     return detail::get_bool("auto reconnect enabled",
       *this, &Api::get_EnableAutoReconnect);
@@ -222,7 +295,7 @@ public:
     DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot set max reconnect attempts");
   }
 
-  LONG max_reconnect_attempts() const
+  [[nodiscard]] LONG max_reconnect_attempts() const
   {
     LONG result{};
     const auto err = detail::api(*this).get_MaxReconnectAttempts(&result);
@@ -244,7 +317,7 @@ public:
     set_authentication_level(value);
   }
 
-  Server_authentication authentication_level() const
+  [[nodiscard]] Server_authentication authentication_level() const
   {
     UINT result{};
     detail::api(*this).get_AuthenticationLevel(&result);
@@ -259,7 +332,7 @@ public:
       *this, &Api::put_RedirectClipboard, value);
   }
 
-  bool is_redirect_clipboard_enabled() const
+  [[nodiscard]] bool is_redirect_clipboard_enabled() const
   {
     return detail::get_bool("redirect clipboard enabled",
       *this, &Api::get_RedirectClipboard);
@@ -271,7 +344,7 @@ public:
       *this, &Api::put_RedirectDevices, value);
   }
 
-  bool is_redirect_devices_enabled() const
+  [[nodiscard]] bool is_redirect_devices_enabled() const
   {
     return detail::get_bool("redirect devices enabled",
       *this, &Api::get_RedirectDevices);
@@ -283,7 +356,7 @@ public:
       *this, &Api::put_RedirectPOSDevices, value);
   }
 
-  bool is_redirect_pos_devices_enabled() const
+  [[nodiscard]] bool is_redirect_pos_devices_enabled() const
   {
     return detail::get_bool("redirect POS devices enabled",
       *this, &Api::get_RedirectPOSDevices);
@@ -303,7 +376,7 @@ public:
     set_network_connection_type(value);
   }
 
-  Network_connection_type network_connection_type() const
+  [[nodiscard]] Network_connection_type network_connection_type() const
   {
     UINT result{};
     detail::api(*this).get_NetworkConnectionType(&result);
@@ -393,7 +466,7 @@ public:
   }
 
   template<class String>
-  void set_domain(const std::string& value)
+  void set_domain(const String& value)
   {
     detail::set("Domain property of RDP client",
       *this, &Api::put_Domain, value);
@@ -405,13 +478,22 @@ public:
     return detail::get<String>(*this, &Api::get_Domain);
   }
 
+  template<class String>
+  void set_clear_text_password(const String& value)
+  {
+    const auto err = api<MSTSCLib::IMsTscNonScriptable>()
+      .put_ClearTextPassword(detail::bstr(value));
+    DMITIGR_WINCOM_THROW_IF_ERROR(err,
+      "cannot set ClearTextPassword property of RDP client");
+  }
+
   void set_prompt_for_credentials_enabled(const bool value)
   {
     detail::set("PromptForCredentials property of RDP client", *this,
       &MSTSCLib::IMsRdpClientNonScriptable3::put_PromptForCredentials, value);
   }
 
-  bool is_prompt_for_credentials_enabled() const noexcept
+  [[nodiscard]] bool is_prompt_for_credentials_enabled() const
   {
     return detail::get_bool("PromptForCredentials property of RDP client",
       *this, &MSTSCLib::IMsRdpClientNonScriptable3::get_PromptForCredentials);
@@ -423,7 +505,7 @@ public:
       &MSTSCLib::IMsRdpClientNonScriptable4::put_PromptForCredsOnClient, value);
   }
 
-  bool is_prompt_for_credentials_on_client_enabled() const noexcept
+  [[nodiscard]] bool is_prompt_for_credentials_on_client_enabled() const
   {
     return detail::get_bool("PromptForCredsOnClient property of RDP client",
       *this, &MSTSCLib::IMsRdpClientNonScriptable4::get_PromptForCredsOnClient);
@@ -436,7 +518,7 @@ public:
       value);
   }
 
-  bool is_allow_prompting_for_credentials_enabled() const noexcept
+  [[nodiscard]] bool is_allow_prompting_for_credentials_enabled() const
   {
     return detail::get_bool("AllowPromptingForCredentials property of RDP client",
       *this,
@@ -450,7 +532,7 @@ public:
       "cannot set DesktopHeight property of RDP client");
   }
 
-  LONG desktop_height() const
+  [[nodiscard]] LONG desktop_height() const
   {
     LONG result{};
     detail::api(*this).get_DesktopHeight(&result);
@@ -464,14 +546,27 @@ public:
       "cannot set DesktopWidth property of RDP client");
   }
 
-  LONG desktop_width() const
+  [[nodiscard]] LONG desktop_width() const
   {
     LONG result{};
     detail::api(*this).get_DesktopWidth(&result);
     return result;
   }
 
-  short connection_state() const
+  /**
+   * @brief Sets both desktop dimensions as one logical operation.
+   *
+   * @remarks The control only accepts these properties before
+   * connecting; during a live session use reconnect() with the new
+   * dimensions instead.
+   */
+  void set_desktop_size(const LONG width, const LONG height)
+  {
+    set_desktop_width(width);
+    set_desktop_height(height);
+  }
+
+  [[nodiscard]] short connection_state() const
   {
     short result{};
     detail::api(*this).get_Connected(&result);
@@ -485,6 +580,27 @@ public:
       "cannot initiate connection to remote RDP server");
   }
 
+  /**
+   * @brief Sets the connection properties and initiates the connection.
+   *
+   * @details Convenience over the set_server()/set_user_name()/
+   * set_domain()/set_clear_text_password()/connect() sequence every
+   * caller otherwise spells out; the properties must be set before
+   * connecting, so fusing them with the connect() keeps that ordering in
+   * one place.
+   */
+  template<class ServerString, class UserString, class DomainString,
+    class PasswordString>
+  void connect_with(const ServerString& server, const UserString& user_name,
+    const DomainString& domain, const PasswordString& password)
+  {
+    set_server(server);
+    set_user_name(user_name);
+    set_domain(domain);
+    set_clear_text_password(password);
+    connect();
+  }
+
   void disconnect()
   {
     const auto err = api().Disconnect();
@@ -544,12 +660,14 @@ public:
 
   void set_property_disable_auto_reconnect_component(const bool value)
   {
+    // The property name is allocated once per process; see the analogous
+    // constants of rdp::Session_properties.
+    static const _bstr_t name{L"DisableAutoReconnectComponent"};
     VARIANT val{};
-    VariantInit(&val);
     val.vt = VT_BOOL;
-    val.boolVal = value ? VARIANT_TRUE : VARIANT_FALSE;
+    val.boolVal = detail::variant_bool(value);
     const auto err = api<MSTSCLib::IMsRdpExtendedSettings>()
-      .put_Property(detail::bstr("DisableAutoReconnectComponent"), &val);
+      .put_Property(name, &val);
     DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot disable auto reconnect component");
   }
 
@@ -21,17 +21,20 @@
 #include "../base/noncopymove.hpp"
 #include "../winbase/combase.hpp"
 #include "exceptions.hpp"
+#include "library.hpp"
 #include "object.hpp"
 
 #include <cstdint>
+#include <future>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <taskschd.h>
 
 namespace dmitigr::wincom::tasc::v2 {
 
-inline const char* to_literal(const TASK_STATE value) noexcept
+[[nodiscard]] constexpr const char* to_literal(const TASK_STATE value) noexcept
 {
   switch (value) {
   case TASK_STATE_UNKNOWN:
@@ -48,7 +51,7 @@ inline const char* to_literal(const TASK_STATE value) noexcept
   return nullptr;
 }
 
-inline const char* to_literal(const TASK_TRIGGER_TYPE2 value) noexcept
+[[nodiscard]] constexpr const char* to_literal(const TASK_TRIGGER_TYPE2 value) noexcept
 {
   switch (value) {
   case TASK_TRIGGER_EVENT:
@@ -210,6 +213,27 @@ public:
     detail::api(*this).get_Repetition(&result);
     return Repetition_pattern{result};
   }
+
+  /// A plain snapshot of the repetition pattern of a trigger.
+  struct Repetition_snapshot final {
+    std::wstring duration;
+    std::wstring interval;
+    bool is_stopped_at_the_end_of_duration{};
+  };
+
+  /**
+   * @returns The plain snapshot of the repetition pattern of this trigger.
+   *
+   * @remarks Fetches the pattern object once and reads all three fields
+   * through it, instead of a fresh get_Repetition round trip per field;
+   * callers then work with plain data.
+   */
+  Repetition_snapshot repetition_snapshot() const
+  {
+    const auto pattern = repetition_pattern();
+    return {pattern.duration<std::wstring>(), pattern.interval<std::wstring>(),
+      pattern.is_stopped_at_the_end_of_duration()};
+  }
 };
 
 class Trigger_collection final :
@@ -234,6 +258,18 @@ public:
     detail::api(*this).get_Item(index, &result);
     return Trigger{result};
   }
+
+  /// @returns The batching iterator over this collection.
+  detail::Enum_iterator<Trigger> begin() const
+  {
+    return detail::enum_begin<Trigger>(*this, &Api::get__NewEnum);
+  }
+
+  /// @returns The past-the-end iterator.
+  detail::Enum_iterator<Trigger> end() const
+  {
+    return {};
+  }
 };
 
 class Task_definition final :
@@ -275,6 +311,18 @@ public:
     return detail::get<String>(*this, &Api::get_Path);
   }
 
+  /// Assigns the name of this task to `result`, reusing its capacity.
+  void name(std::wstring& result) const
+  {
+    detail::get(*this, &Api::get_Name, result);
+  }
+
+  /// Assigns the path of this task to `result`, reusing its capacity.
+  void path(std::wstring& result) const
+  {
+    detail::get(*this, &Api::get_Path, result);
+  }
+
   TASK_STATE state() const
   {
     TASK_STATE result{};
@@ -323,9 +371,54 @@ public:
   Registered_task item(const LONG index) const
   {
     IRegisteredTask* result{};
-    detail::api(*this).get_Item(_variant_t(index), &result);
+    VARIANT idx{};
+    idx.vt = VT_I4;
+    idx.lVal = index;
+    detail::api(*this).get_Item(idx, &result);
     return Registered_task{result};
   }
+
+  /// @returns The batching iterator over this collection.
+  detail::Enum_iterator<Registered_task> begin() const
+  {
+    return detail::enum_begin<Registered_task>(*this, &Api::get__NewEnum);
+  }
+
+  /// @returns The past-the-end iterator.
+  detail::Enum_iterator<Registered_task> end() const
+  {
+    return {};
+  }
+
+  /// A plain snapshot of a registered task.
+  struct Task_snapshot final {
+    std::wstring name;
+    std::wstring path;
+    TASK_STATE state{};
+    DATE last_run_time{};
+    DATE next_run_time{};
+  };
+
+  /**
+   * @returns The plain snapshots of all the tasks of this collection.
+   *
+   * @remarks The Task Scheduler service runs out of process, so every
+   * field access on a Registered_task is a marshaled call. The snapshot
+   * pays them once per task at a single point; callers then iterate
+   * plain data instead of re-entering COM per field and per repaint.
+   */
+  std::vector<Task_snapshot> snapshot() const
+  {
+    const auto task_count = count();
+    std::vector<Task_snapshot> result;
+    result.reserve(static_cast<std::size_t>(task_count));
+    for (LONG i{1}; i <= task_count; ++i) {
+      const auto task = item(i);
+      result.push_back({task.name<std::wstring>(), task.path<std::wstring>(),
+        task.state(), task.last_run_time(), task.next_run_time()});
+    }
+    return result;
+  }
 };
 
 class Task_folder;
@@ -347,6 +440,15 @@ public:
    * @param index 1-based index.
    */
   Task_folder item(LONG index) const;
+
+  /// @returns The batching iterator over this collection.
+  detail::Enum_iterator<Task_folder> begin() const;
+
+  /// @returns The past-the-end iterator.
+  detail::Enum_iterator<Task_folder> end() const
+  {
+    return {};
+  }
 };
 
 class Task_folder final :
@@ -382,10 +484,51 @@ public:
 Task_folder Task_folder_collection::item(const LONG index) const
 {
   ITaskFolder* result{};
-  detail::api(*this).get_Item(_variant_t(index), &result);
+  VARIANT idx{};
+  idx.vt = VT_I4;
+  idx.lVal = index;
+  detail::api(*this).get_Item(idx, &result);
   return Task_folder{result};
 }
 
+inline detail::Enum_iterator<Task_folder>
+Task_folder_collection::begin() const
+{
+  return detail::enum_begin<Task_folder>(*this, &Api::get__NewEnum);
+}
+
+/**
+ * @brief Calls `visit` for `root` and each folder of its subtree, walking
+ * the immediate subtrees of `root` concurrently.
+ *
+ * @par Requires
+ * The calling thread must live in the multithreaded apartment and `visit`
+ * must be safe to call concurrently.
+ *
+ * @remarks Every call to the Task Scheduler service blocks on an RPC, so
+ * a serial walk of a large tree is bound by latency rather than CPU. The
+ * subtrees are independent, thus each one is walked in its own thread
+ * (which initializes COM for itself, see Library).
+ */
+template<typename F>
+void walk_folders(const Task_folder& root, const F& visit)
+{
+  visit(root);
+  const auto subfolders = root.folders();
+  const auto subfolder_count = subfolders.count();
+  std::vector<std::future<void>> walks;
+  walks.reserve(static_cast<std::size_t>(subfolder_count));
+  for (LONG i{1}; i <= subfolder_count; ++i)
+    walks.emplace_back(std::async(std::launch::async,
+      [subfolder = subfolders.item(i), &visit]
+      {
+        const Library library{COINIT_MULTITHREADED};
+        walk_folders(subfolder, visit);
+      }));
+  for (auto& walk : walks)
+    walk.get(); // rethrows the failure of a subtree walk, if any
+}
+
 class Task_service final : public Basic_com_object<TaskScheduler, ITaskService> {
   using Bco = Basic_com_object<TaskScheduler, ITaskService>;
 public:
@@ -402,8 +545,8 @@ public:
       domain.data(),
       password.data());
     DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot connect to remote computer and"
-      " associate all subsequent calls on "+std::string{"ITaskService"}
-      +" interface with a local (remote) session");
+      " associate all subsequent calls on ITaskService interface with a local"
+      " (remote) session");
   }
 
   bool is_connected() const
@@ -413,11 +556,27 @@ public:
     return result == VARIANT_TRUE;
   }
 
+  /**
+   * @brief Connects as connect() does, but only if not is_connected().
+   *
+   * @details Lets pollers keep one Task_service instance warm across
+   * many queries instead of constructing (CoCreateInstance) and
+   * connecting a fresh one per poll.
+   */
+  void connect_if_needed(const winbase::com::Const_variant& server_name = {},
+    const winbase::com::Const_variant& user = {},
+    const winbase::com::Const_variant& domain = {},
+    const winbase::com::Const_variant& password = {})
+  {
+    if (!is_connected())
+      connect(server_name, user, domain, password);
+  }
+
   template<class String>
   Task_folder folder(const String& path) const
   {
     ITaskFolder* result{};
-    const auto err = detail::api(*this).GetFolder(_bstr_t(path.c_str()), &result);
+    const auto err = detail::api(*this).GetFolder(detail::in_bstr(path), &result);
     DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot get folder of registered tasks");
     return Task_folder{result};
   }
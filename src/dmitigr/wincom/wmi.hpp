@@ -23,14 +23,72 @@
 #include "exceptions.hpp"
 #include "object.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <Wbemidl.h>
 
 namespace dmitigr::wincom::wmi {
 
+/**
+ * @brief A handle-based accessor of class object properties.
+ *
+ * @details Looking a property up by name hashes the name inside the WMI
+ * proxy on every Get() call. A property handle is resolved once per
+ * (class, property name) pair and stays valid for every instance of that
+ * class, so enumeration loops reading the same properties from thousands
+ * of objects should resolve the handles up front and fetch by handle.
+ */
+class Object_access final :
+    public Unknown_api<Object_access, IWbemObjectAccess> {
+  using Ua = Unknown_api<Object_access, IWbemObjectAccess>;
+public:
+  using Ua::Ua;
+
+  /// @returns The handle of the property `name`.
+  LONG property_handle(const LPCWSTR name) const
+  {
+    if (!name)
+      throw std::invalid_argument{"cannot get property handle of"
+        " IWbemObjectAccess: invalid name"};
+
+    LONG result{};
+    CIMTYPE type{};
+    const auto err = detail::api(*this).GetPropertyHandle(name, &type, &result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot get handle of property "
+      +winbase::utf16_to_utf8(name)+" of IWbemObjectAccess");
+    return result;
+  }
+
+  /// @returns The value of the DWORD-sized property denoted by `handle`.
+  DWORD dword(const LONG handle) const
+  {
+    DWORD result{};
+    const auto err = detail::api(*this).ReadDWORD(handle, &result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err,
+      "cannot read DWORD property of IWbemObjectAccess");
+    return result;
+  }
+
+  /// @returns The value of the QWORD-sized property denoted by `handle`.
+  unsigned __int64 qword(const LONG handle) const
+  {
+    unsigned __int64 result{};
+    const auto err = detail::api(*this).ReadQWORD(handle, &result);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err,
+      "cannot read QWORD property of IWbemObjectAccess");
+    return result;
+  }
+};
+
 class Class_object final :
     public Unknown_api<Class_object, IWbemClassObject> {
   using Ua = Unknown_api<Class_object, IWbemClassObject>;
@@ -55,6 +113,15 @@ public:
       +winbase::utf16_to_utf8(name)+" of IWbemClassObject");
     return value;
   }
+
+  /// @returns The handle-based accessor of this object, or an invalid
+  /// instance if the object doesn't support IWbemObjectAccess.
+  Object_access access() const
+  {
+    IWbemObjectAccess* raw{};
+    detail::api(*this).QueryInterface(&raw);
+    return Object_access{raw};
+  }
 };
 
 class Enum_class_object final :
@@ -75,6 +142,157 @@ public:
         "cannot get next object of IEnumWbemClassObject");
     return Class_object{};
   }
+
+  /**
+   * @returns Up to `count` next objects of the enumeration. The result is
+   * smaller than `count` (possibly empty) once the enumeration is exhausted.
+   *
+   * @remarks WMI marshals every Next() call to the provider, so requesting
+   * one object at a time pays a round trip per object. Fetching a batch
+   * amortizes that cost across up to 32 objects per call.
+   */
+  std::vector<Class_object> next_batch(const ULONG count,
+    const long timeout = WBEM_INFINITE)
+  {
+    constexpr ULONG max_batch_size{32};
+    std::vector<Class_object> result;
+    result.reserve(std::min(count, max_batch_size));
+    for (ULONG remaining{count}; remaining;) {
+      IWbemClassObject* buf[max_batch_size]{};
+      const auto batch_size = std::min(remaining, max_batch_size);
+      ULONG fetched{};
+      const auto err = api().Next(timeout, batch_size, buf, &fetched);
+      for (ULONG i{}; i < fetched; ++i)
+        result.emplace_back(Class_object{buf[i]});
+      if (err == WBEM_S_FALSE)
+        break;
+      else if (err != WBEM_S_NO_ERROR)
+        DMITIGR_WINCOM_THROW_IF_ERROR(err,
+          "cannot get next objects of IEnumWbemClassObject");
+      remaining -= fetched;
+    }
+    return result;
+  }
+};
+
+/**
+ * @brief An object sink accepting the results of an asynchronous query.
+ *
+ * @details WMI pushes objects into Indicate() from its own threads as
+ * they arrive, while the consumer drains them with next(). This overlaps
+ * the processing of early results with the retrieval of later ones,
+ * unlike the enumerator of exec_query() whose Next() call is a lock-step
+ * round trip.
+ *
+ * @remarks The sink is owned externally (like Advise_sink): keep it
+ * alive until the call completes or is canceled via cancel_async_call().
+ */
+class Object_sink final : public IWbemObjectSink, private Noncopymove {
+public:
+  // IUnknown overrides
+
+  HRESULT QueryInterface(REFIID id, void** const object) override
+  {
+    if (!object)
+      return E_POINTER;
+
+    if (id == __uuidof(IWbemObjectSink) || id == __uuidof(IUnknown)) {
+      *object = static_cast<IWbemObjectSink*>(this);
+      AddRef();
+      return S_OK;
+    }
+
+    *object = nullptr;
+    return E_NOINTERFACE;
+  }
+
+  ULONG AddRef() override
+  {
+    // Relaxed suffices for taking a reference: acquiring one implies
+    // the caller already holds one.
+    return ref_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  ULONG Release() override
+  {
+    /*
+     * Release ordering publishes all prior writes to whoever drops the
+     * count to zero; the acquire fence on that final path pairs with it.
+     * The sink is owned externally, so no delete happens here.
+     */
+    const auto prev = ref_count_.fetch_sub(1, std::memory_order_release);
+    DMITIGR_ASSERT(prev >= 1); // catches an unbalanced Release()
+    if (prev == 1)
+      std::atomic_thread_fence(std::memory_order_acquire);
+    return prev - 1;
+  }
+
+  // IWbemObjectSink overrides
+
+  HRESULT Indicate(const long count,
+    IWbemClassObject** const objects) override
+  {
+    if (count > 0 && !objects)
+      return WBEM_E_INVALID_PARAMETER;
+
+    {
+      const std::lock_guard lg{mutex_};
+      for (long i{}; i < count; ++i) {
+        objects[i]->AddRef();
+        queue_.emplace_back(Class_object{objects[i]});
+      }
+    }
+    has_result_.notify_all();
+    return WBEM_S_NO_ERROR;
+  }
+
+  HRESULT SetStatus(const long flags, const HRESULT result,
+    BSTR, IWbemClassObject*) override
+  {
+    if (flags == WBEM_STATUS_COMPLETE) {
+      {
+        const std::lock_guard lg{mutex_};
+        is_complete_ = true;
+        status_ = result;
+      }
+      has_result_.notify_all();
+    }
+    return WBEM_S_NO_ERROR;
+  }
+
+  // Consumer API
+
+  /**
+   * @returns The next object of the result, blocking until one arrives,
+   * or `std::nullopt` when the call has completed and the queue is
+   * drained.
+   *
+   * @throws Win_error if the call has completed with an error.
+   */
+  std::optional<Class_object> next()
+  {
+    std::unique_lock lk{mutex_};
+    has_result_.wait(lk, [this]
+    {
+      return !queue_.empty() || is_complete_;
+    });
+    if (!queue_.empty()) {
+      auto result = std::move(queue_.front());
+      queue_.pop_front();
+      return result;
+    }
+    DMITIGR_WINCOM_THROW_IF_ERROR(status_,
+      "cannot complete asynchronous query to WMI services");
+    return std::nullopt;
+  }
+
+private:
+  std::atomic<ULONG> ref_count_{};
+  std::mutex mutex_;
+  std::condition_variable has_result_;
+  std::deque<Class_object> queue_;
+  bool is_complete_{};
+  HRESULT status_{WBEM_S_NO_ERROR};
 };
 
 class Services final : public Unknown_api<Services, IWbemServices> {
@@ -98,6 +316,33 @@ public:
     return Enum_class_object{result};
   }
 
+  /**
+   * @brief Executes `query` asynchronously, pushing the results into
+   * `sink` as they arrive.
+   *
+   * @see Object_sink, cancel_async_call().
+   */
+  template<class String>
+  void exec_query_async(const String& query, IWbemObjectSink& sink,
+    const long flags = {}, IWbemContext* const ctx = {}) const
+  {
+    const auto err = detail::api(*this).ExecQueryAsync(detail::bstr("WQL"),
+      detail::bstr(query),
+      flags,
+      ctx,
+      &sink);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err, "cannot execute asynchronous query"
+      " to retrieve objects from WMI services");
+  }
+
+  /// Cancels the asynchronous call currently targeting `sink`.
+  void cancel_async_call(IWbemObjectSink& sink) const
+  {
+    const auto err = detail::api(*this).CancelAsyncCall(&sink);
+    DMITIGR_WINCOM_THROW_IF_ERROR(err,
+      "cannot cancel asynchronous call to WMI services");
+  }
+
   /**
    * @returns Object from the namespace associated with this instance.
    *
@@ -19,10 +19,11 @@
 #include "../base/noncopymove.hpp"
 #include "../winbase/windows.hpp"
 
-#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <stdexcept>
+#include <utility>
 
 #include <comdef.h> // avoid LNK2019
 #include <Oleidl.h>
@@ -69,6 +70,11 @@ public:
         ole_in_place_active_object_ = {};
       }
 
+      if (ole_in_place_object_) {
+        ole_in_place_object_->Release();
+        ole_in_place_object_ = {};
+      }
+
       assert(ole_object_);
       ole_object_->Release();
       ole_object_ = {};
@@ -77,14 +83,20 @@ public:
 
   explicit Site(IUnknown* const com, const HWND window)
     : window_{window}
+    , parent_{GetParent(window)}
   {
-    if (!com || !window_ || !GetParent(window))
+    if (!com || !window_ || !parent_)
       throw std::invalid_argument{"cannot create OLE site instance"};
 
     if (com->QueryInterface(&ole_object_) != S_OK)
       throw std::runtime_error{"cannot query IOleObject "
         "upon of OLE site instance creation"};
 
+    // The in-place interface of the object never changes, so query it
+    // once here instead of per deactivation and per WM_SIZE: each query
+    // is a marshaled call for an out-of-process object.
+    ole_object_->QueryInterface(&ole_in_place_object_);
+
     if (ole_object_->SetClientSite(this) != S_OK)
       throw std::runtime_error{"cannot inform IOleObject of its display location "
         "upon of OLE site instance creation"};
@@ -100,11 +112,24 @@ public:
     return window_;
   }
 
+  /// @returns The parent of window(), fixed for the lifetime of the site.
+  HWND parent() const noexcept
+  {
+    return parent_;
+  }
+
   IOleObject* ole_object() const noexcept
   {
     return ole_object_;
   }
 
+  /// @returns The in-place interface of ole_object(), or `nullptr` if
+  /// the object is not activatable in place.
+  IOleInPlaceObject* ole_in_place_object() const noexcept
+  {
+    return ole_in_place_object_;
+  }
+
   void set_ole_in_place_active_object(IOleInPlaceActiveObject* const obj)
   {
     ole_in_place_active_object_ = obj;
@@ -143,8 +168,8 @@ public:
     const char* errmsg{};
 
     {
-      IOleInPlaceObject* in_place_obj{};
-      if (ole_object()->QueryInterface(&in_place_obj) != S_OK)
+      IOleInPlaceObject* const in_place_obj{ole_in_place_object()};
+      if (!in_place_obj)
         errmsg = "cannot query interface upon deactivation of OLE site in place";
 
       if (!errmsg && in_place_obj->UIDeactivate() != S_OK)
@@ -152,8 +177,6 @@ public:
 
       if (!errmsg && in_place_obj->InPlaceDeactivate() != S_OK)
         errmsg ="cannot deactivate in place upon of deactivation of OLE site in place";
-
-      in_place_obj->Release();
     }
 
     if (!errmsg && !InvalidateRect(window_, 0, true))
@@ -172,31 +195,50 @@ public:
 
   HRESULT QueryInterface(REFIID iid, void** const object) override
   {
-    if (iid == __uuidof(IUnknown))
-      *object = static_cast<IUnknown*>(static_cast<IOleClientSite*>(this));
-    else if (iid == __uuidof(IOleClientSite))
-      *object = static_cast<IOleClientSite*>(this);
-    else if (iid == __uuidof(IOleInPlaceSite))
-      *object = static_cast<IOleInPlaceSite*>(this);
-    else if (iid == __uuidof(IOleInPlaceFrame))
-      *object = static_cast<IOleInPlaceFrame*>(this);
-    else {
-      *object = nullptr;
-      return E_NOINTERFACE;
+    /*
+     * Table QI, as in Advise_sink: the supported IIDs sit in one array
+     * scanned by a tight loop instead of a chain of dependent branches.
+     * Unlike there, the bases are multiply inherited, so each entry
+     * carries its own adjusted object pointer.
+     */
+    const std::pair<const IID*, void*> iids[]{
+      {&__uuidof(IUnknown),
+        static_cast<IUnknown*>(static_cast<IOleClientSite*>(this))},
+      {&__uuidof(IOleClientSite), static_cast<IOleClientSite*>(this)},
+      {&__uuidof(IOleInPlaceSite), static_cast<IOleInPlaceSite*>(this)},
+      {&__uuidof(IOleInPlaceFrame), static_cast<IOleInPlaceFrame*>(this)}};
+    for (const auto& [entry_iid, entry_object] : iids) {
+      if (iid == *entry_iid) {
+        *object = entry_object;
+        AddRef();
+        return S_OK;
+      }
     }
 
-    AddRef();
-    return S_OK;
+    *object = nullptr;
+    return E_NOINTERFACE;
   }
 
   ULONG AddRef() override
   {
-    return ++ref_count_;
+    // Relaxed suffices for taking a reference: acquiring one implies
+    // the caller already holds one.
+    return ref_count_.fetch_add(1, std::memory_order_relaxed) + 1;
   }
 
   ULONG Release() override
   {
-    return ref_count_ = std::max(--ref_count_, ULONG(0));
+    /*
+     * Release ordering publishes all prior writes to whoever drops the
+     * count to zero; the acquire fence on that final path pairs with it.
+     * The site is owned by its window (see WM_DESTROY in wnd_proc()),
+     * so no delete happens here.
+     */
+    const auto prev = ref_count_.fetch_sub(1, std::memory_order_release);
+    assert(prev >= 1);
+    if (prev == 1)
+      std::atomic_thread_fence(std::memory_order_acquire);
+    return prev - 1;
   }
 
   // ---------------------------------------------------------------------------
@@ -227,8 +269,13 @@ public:
 
   HRESULT OnShowWindow(BOOL) override
   {
+    // A hidden window gets a WM_PAINT for the whole client area when it
+    // is shown anyway, so invalidating it here is wasted GDI work.
+    if (!IsWindowVisible(window_))
+      return S_OK;
+
     InvalidateRect(window_, 0, true);
-    InvalidateRect(GetParent(window_), 0, true);
+    InvalidateRect(parent_, 0, true);
     return S_OK;
   }
 
@@ -277,10 +324,10 @@ public:
 
     *window = nullptr;
     GetClientRect(window_, rect1);
-    GetClientRect(window_, rect2);
+    *rect2 = *rect1;
     finfo->cb = sizeof(OLEINPLACEFRAMEINFO);
     finfo->fMDIApp = false;
-    finfo->hwndFrame = GetParent(window_);
+    finfo->hwndFrame = parent_;
     finfo->haccel = 0;
     finfo->cAccelEntries = 0;
 
@@ -374,10 +421,15 @@ public:
   }
 
 private:
-  ULONG ref_count_{};
+  std::atomic<ULONG> ref_count_{};
   HWND window_{};
+  HWND parent_{};
   IOleObject* ole_object_{};
+  IOleInPlaceObject* ole_in_place_object_{};
   IOleInPlaceActiveObject* ole_in_place_active_object_{};
+  // The object rects last passed to SetObjectRects(). Only touched from
+  // wnd_proc() on the thread owning window_, so no synchronization.
+  RECT object_rect_{};
   bool is_in_place_activated_{};
 };
 
@@ -429,17 +481,24 @@ inline LRESULT CALLBACK Site::wnd_proc(const HWND window, const UINT message,
         nh.hwndFrom = window;
         nh.idFrom = GetWindowLong(window, GWL_ID);
         nh.code = 1;
-        SendMessage(GetParent(window), WM_NOTIFY, 0, reinterpret_cast<LPARAM>(&nh));
+        SendMessage(site->parent(), WM_NOTIFY, 0,
+          reinterpret_cast<LPARAM>(&nh));
       }
 
-      IOleInPlaceObject* in_place_obj{};
-      if (site->ole_object()->QueryInterface(&in_place_obj) != S_OK)
+      IOleInPlaceObject* const in_place_obj{site->ole_in_place_object()};
+      if (!in_place_obj)
         return 0;
 
       RECT rect{};
       GetClientRect(window, &rect);
+      // WM_SIZE storms during a splitter drag often repeat the same
+      // dimensions; skip the marshaled SetObjectRects() in that case.
+      const auto& prev = site->object_rect_;
+      if (rect.left == prev.left && rect.top == prev.top &&
+        rect.right == prev.right && rect.bottom == prev.bottom)
+        break;
+      site->object_rect_ = rect;
       in_place_obj->SetObjectRects(&rect, &rect);
-      in_place_obj->Release();
     }
     break;
 
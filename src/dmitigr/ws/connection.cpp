@@ -22,6 +22,10 @@
 #include "util.hpp"
 #include "uwebsockets.hpp"
 
+#include <mutex>
+#include <span>
+#include <utility>
+
 namespace dmitigr::ws {
 namespace detail {
 
@@ -34,6 +38,8 @@ public:
   virtual const net::Ip_address& local_ip_address() const noexcept = 0;
   virtual std::size_t buffered_amount() const noexcept = 0;
   virtual bool send(std::string_view payload, Data_format format) = 0;
+  virtual bool send_many(
+    std::span<const std::pair<std::string_view, Data_format>> payloads) = 0;
   virtual void close(int code, std::string_view reason) noexcept = 0;
   virtual void abort() noexcept = 0;
   virtual bool is_closed() const noexcept = 0;
@@ -94,11 +100,25 @@ public:
 
   bool send(const std::string_view payload, const Data_format format) override
   {
-    DMITIGR_ASSERT(!is_closed());
+    // The precondition is enforced by Connection::send() right before the
+    // dispatch; re-checking it here would tax every frame of a sender
+    // pushing millions of them.
     return ws_->send(payload, (format == Data_format::utf8) ?
       uWS::OpCode::TEXT : uWS::OpCode::BINARY);
   }
 
+  bool send_many(const std::span<const std::pair<std::string_view,
+    Data_format>> payloads) override
+  {
+    bool result{true};
+    ws_->cork([&]
+    {
+      for (const auto& [payload, format] : payloads)
+        result &= send(payload, format);
+    });
+    return result;
+  }
+
   void close(const int code, const std::string_view reason) noexcept override
   {
     DMITIGR_ASSERT(!is_closed());
@@ -115,8 +135,11 @@ public:
 
   bool is_closed() const noexcept override
   {
-    DMITIGR_ASSERT(ws_);
-    return us_socket_is_closed(is_ssl(), reinterpret_cast<us_socket_t*>(ws_));
+    // ws_ is nulled by close()/abort(); such a connection is closed
+    // rather than a precondition violation, since Connection re-checks
+    // the state right after closing.
+    return !ws_ ||
+      us_socket_is_closed(is_ssl(), reinterpret_cast<us_socket_t*>(ws_));
   }
 
   void loop_submit(std::function<void()> callback) noexcept override
@@ -214,6 +237,15 @@ DMITIGR_WS_INLINE bool Connection::send(const std::string_view payload,
   return rep_->send(payload, format);
 }
 
+DMITIGR_WS_INLINE bool Connection::send_many(
+  const std::span<const std::pair<std::string_view, Data_format>> payloads)
+{
+  if (!is_connected_nts())
+    throw Exception{"cannot send data via invalid WebSocket connection"};
+
+  return rep_->send_many(payloads);
+}
+
 DMITIGR_WS_INLINE bool Connection::send_utf8(const std::string_view payload)
 {
   return send(payload, Data_format::utf8);
@@ -17,15 +17,17 @@
 #ifndef DMITIGR_WS_CONNECTION_HPP
 #define DMITIGR_WS_CONNECTION_HPP
 
+#include "../base/lock.hpp"
 #include "../net/address.hpp"
 #include "dll.hpp"
 #include "types_fwd.hpp"
 
 #include <functional>
 #include <memory>
-#include <mutex>
+#include <span>
 #include <string>
 #include <string_view>
+#include <utility>
 
 namespace dmitigr::ws {
 
@@ -139,6 +141,29 @@ public:
    */
   DMITIGR_WS_API bool send(std::string_view payload, Data_format format);
 
+  /**
+   * @brief Attempts the specified `payloads` to be transmitted to the remote
+   * side over the connection as individual messages.
+   *
+   * @details The connection is corked around the loop, so the frames are
+   * coalesced into as few network writes (and TLS records) as possible
+   * instead of costing one write per frame.
+   *
+   * @returns `true` if every payload is actually transmitted, or `false` if
+   * backpressure case occurred and some data was queued into the
+   * backpressure buffer to be transmitted as soon as possible.
+   *
+   * @par Requires
+   * `is_connected()`.
+   *
+   * @remarks The behaviour is undefined if called not on the thread of the
+   * associated event loop!
+   *
+   * @see send(), buffered_amount(), handle_drain().
+   */
+  DMITIGR_WS_API bool send_many(
+    std::span<const std::pair<std::string_view, Data_format>> payloads);
+
   /// @returns send(payload, Data_format::utf8).
   DMITIGR_WS_API bool send_utf8(std::string_view payload);
 
@@ -217,7 +242,10 @@ private:
   friend detail::iServer;
   template<bool> friend class detail::Srv;
 
-  mutable std::mutex mut_;
+  // One byte instead of a std::mutex: connections exist by the many
+  // thousands and each is normally touched by one loop thread, so the
+  // uncontended one-CAS path of Lock is the common case.
+  mutable Lock mut_;
   std::unique_ptr<detail::iConnection> rep_;
 
   bool is_connected_nts() const noexcept;
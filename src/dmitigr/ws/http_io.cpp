@@ -15,17 +15,41 @@
 // limitations under the License.
 
 #include "../base/assert.hpp"
+#include "../base/lock.hpp"
 #include "../http/errc.hpp"
 #include "exceptions.hpp"
 #include "http_io.hpp"
 #include "util.hpp"
 #include "uwebsockets.hpp"
 
+#include <array>
 #include <mutex>
 #include <string>
 
 namespace dmitigr::ws::detail {
 
+/**
+ * @returns The complete status line for `code`.
+ *
+ * @details The set of statuses is bounded and known, so the lines are built
+ * once upon the first call instead of being formatted (with heap traffic)
+ * on every response.
+ */
+inline std::string_view status_line(const http::Server_errc code)
+{
+  static const auto lines = []
+  {
+    std::array<std::string, 600> result;
+    for (int c{}; c < 600; ++c)
+      result[static_cast<std::size_t>(c)] = std::to_string(c).append(" ")
+        .append(to_literal_anyway(static_cast<http::Server_errc>(c)));
+    return result;
+  }();
+  const auto index = static_cast<std::size_t>(code);
+  return index < lines.size() ? std::string_view{lines[index]}
+    : std::string_view{lines[0]};
+}
+
 class iHttp_io : public Http_io {
   template<bool> friend class iHttp_io_templ;
 
@@ -114,8 +138,7 @@ public:
     if (!is_valid_nts())
       throw Exception{"cannot send HTTP status line: invalid HTTP I/O"};
 
-    rep_->writeStatus(std::to_string(static_cast<int>(code)).append(" ")
-      .append(to_literal_anyway(code)));
+    rep_->writeStatus(status_line(code));
   }
 
   void send_header(const std::string_view name, const std::string_view value) override
@@ -127,6 +150,22 @@ public:
     rep_->writeHeader(name, value);
   }
 
+  void respond(const http::Server_errc code, const Headers headers,
+    const std::string_view data = {}) override
+  {
+    const std::lock_guard lg{mut_};
+    if (!is_valid_nts())
+      throw Exception{"cannot send HTTP response: invalid HTTP I/O"};
+
+    rep_->cork([this, code, headers, data]
+    {
+      rep_->writeStatus(status_line(code));
+      for (const auto& [name, value] : headers)
+        rep_->writeHeader(name, value);
+      end_nts(data);
+    });
+  }
+
   std::pair<bool, bool> send_content(const std::string_view data,
     const std::uintmax_t total_size) override
   {
@@ -171,12 +210,18 @@ public:
 
     rep_->onWritable([this, hndlr = std::move(handler)](const std::uintmax_t pos)
     {
-      const std::lock_guard lg{mut_};
+      /*
+       * Runs on the loop thread, the only writer of rep_, so reading it
+       * needs no lock. The handler itself is invoked unlocked: it may
+       * legitimately call back into this object (end(), abort()), and
+       * mut_ is non-recursive. The lock is taken only to publish the
+       * rep_ reset to readers on other threads.
+       */
       DMITIGR_ASSERT(rep_);
       const auto ok = hndlr(pos);
       if (ok) {
+        const std::lock_guard lg{mut_};
         rep_ = nullptr;
-        DMITIGR_ASSERT(!is_valid_nts());
       }
       return ok;
     });
@@ -211,10 +256,10 @@ public:
 
     rep_->onAborted([this, hndlr = std::move(handler)]
     {
-      const std::lock_guard lg{mut_};
+      // Unlocked for the same reasons as in the onWritable callback.
       hndlr();
+      const std::lock_guard lg{mut_};
       rep_ = nullptr;
-      DMITIGR_ASSERT(!is_valid_nts());
     });
     is_abort_handler_set_ = true;
   }
@@ -248,7 +293,8 @@ public:
 private:
   template<bool> friend class detail::Srv;
 
-  mutable std::mutex mut_;
+  // See the remark on Connection::mut_ for the choice of Lock.
+  mutable Lock mut_;
   bool is_abort_handler_set_{};
   bool is_send_handler_set_{};
   bool is_receive_handler_set_{};
@@ -22,6 +22,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <initializer_list>
 #include <string_view>
 #include <utility>
 
@@ -180,6 +181,35 @@ public:
    */
   virtual void send_header(std::string_view name, std::string_view value) = 0;
 
+  /// The alias of the header list of respond().
+  using Headers = std::initializer_list<
+    std::pair<std::string_view, std::string_view>>;
+
+  /**
+   * @brief Sends the complete response and finishes the IO.
+   *
+   * @details Equivalent to send_status(), followed by send_header() per
+   * element of `headers`, followed by `end(data)`, except that the whole
+   * response leaves corked - one buffer, one write (and one TLS record on a
+   * secure connection) instead of one per call.
+   *
+   * @par Requires
+   * `is_valid()`.
+   *
+   * @par Effects
+   * `!is_valid()`.
+   *
+   * @par Thread safety
+   * Thread-safe.
+   *
+   * @remarks The behaviour is undefined if called not on the thread of the
+   * associated event loop!
+   *
+   * @see loop_submit(), send_status(), send_header(), end().
+   */
+  virtual void respond(http::Server_errc code, Headers headers,
+    std::string_view data = {}) = 0;
+
   /**
    * @brief Attempts to send (a portion) of the content.
    *